@@ -37,6 +37,11 @@ modded class SCR_PlayerController : PlayerController
 	private bool m_bIsFocusInputHeld;
 	private float m_fFocusInputDelayTimer;
 	private bool m_bIsInitialized;
+	
+	// Focus intensities from the user settings, refreshed only when the settings change.
+	private static float s_fFocusInADS;
+	private static float s_fFocusInPIP;
+	private static bool s_bFocusSettingsCached;
 
 	//------------------------------------------------------------------------------------------------
 	override void OnUpdate(float timeSlice)
@@ -47,8 +52,8 @@ modded class SCR_PlayerController : PlayerController
 			return;
 			
 		// If the system is disabled in the config, do nothing.
-		NarcoFovAndZoomSettings settings = NarcoJsonSettingsManager.GetInstance().GetFovAndZoomSettings();
-		if (!settings || !settings.m_bEnabled)
+		NarcoSettingsSnapshot settings = NarcoSettingsSnapshot.Get();
+		if (!settings.m_bFovAndZoomEnabled)
 			return;
 
 		// This method now ONLY manages the timers and cooldowns for the zoom ability.
@@ -81,8 +86,8 @@ modded class SCR_PlayerController : PlayerController
 		if (!m_CharacterController)
 			return 0;
 			
-		NarcoFovAndZoomSettings settings = NarcoJsonSettingsManager.GetInstance().GetFovAndZoomSettings();
-		if (!settings || !settings.m_bEnabled)
+		NarcoSettingsSnapshot settings = NarcoSettingsSnapshot.Get();
+		if (!settings.m_bFovAndZoomEnabled)
 			return super.GetFocusValue(adsProgress, dt); // Use default game logic if disabled
 
 		// If ADS has just started AND our ability timer was JUST activated, it was a mistake.
@@ -96,20 +101,14 @@ modded class SCR_PlayerController : PlayerController
 		// Let the game handle its own ADS zoom.
 		if (adsProgress > 0)
 		{
+			if (!s_bFocusSettingsCached)
+				CacheFocusSettings();
+			
 			float currentFocus = 0;
-			BaseContainer fovSettings = GetGame().GetGameUserSettings().GetModule("Narco_FieldOfViewSettings");
-			float adsIntensity = 0.0;
-			float pipIntensity = 0.0;
-			if (fovSettings)
-			{
-				fovSettings.Get("m_fFocusInADS", adsIntensity);
-				fovSettings.Get("m_fFocusInPIP", pipIntensity);
-			}
-
 			if (SCR_2DPIPSightsComponent.IsPIPActive())
-				currentFocus = Math.Lerp(adsIntensity, 1.0, pipIntensity);
+				currentFocus = Math.Lerp(s_fFocusInADS, 1.0, s_fFocusInPIP);
 			else
-				currentFocus = adsIntensity;
+				currentFocus = s_fFocusInADS;
 
 			currentFocus *= Math.Min(adsProgress, 1.0);
 
@@ -165,19 +164,14 @@ modded class SCR_PlayerController : PlayerController
 	}
 
 	//------------------------------------------------------------------------------------------------
-	//! This function is now used to enforce the server's settings on the client.
+	//! This function is now used to enforce the server's settings on the client. Clients use the replicated snapshot.
 	override static void SetGameUserSettings()
 	{
 		super.SetGameUserSettings();
 		
-		NarcoJsonSettingsManager settingsManager = NarcoJsonSettingsManager.GetInstance();
-		if (!settingsManager) return;
-		
-		NarcoFovAndZoomSettings fovConfig = settingsManager.GetFovAndZoomSettings();
-		if (!fovConfig || !fovConfig.m_bEnabled) return;
-
+		NarcoSettingsSnapshot fovConfig = NarcoSettingsSnapshot.Get();
 		BaseContainer userFovSettings = GetGame().GetGameUserSettings().GetModule("Narco_FieldOfViewSettings");
-		if (userFovSettings)
+		if (fovConfig.m_bFovAndZoomEnabled && userFovSettings)
 		{
 			float loadedValue;
 
@@ -196,13 +190,106 @@ modded class SCR_PlayerController : PlayerController
 			if (userFovSettings.Get("m_fFocusInPIP", loadedValue))
 				userFovSettings.Set("m_fFocusInPIP", Math.Clamp(loadedValue, 0.0, fovConfig.m_fMaxPipIntensity));
 		}
+		
+		CacheFocusSettings();
+		
+		SCR_CameraManager cameraManager = SCR_CameraManager.Cast(GetGame().GetCameraManager());
+		if (cameraManager)
+			cameraManager.CacheFovSettings();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Copies the focus intensities out of the user settings. Subscribes to later changes on first use.
+	static void CacheFocusSettings()
+	{
+		s_fFocusInADS = 0;
+		s_fFocusInPIP = 0;
+		
+		BaseContainer fovSettings = GetGame().GetGameUserSettings().GetModule("Narco_FieldOfViewSettings");
+		if (fovSettings)
+		{
+			fovSettings.Get("m_fFocusInADS", s_fFocusInADS);
+			fovSettings.Get("m_fFocusInPIP", s_fFocusInPIP);
+		}
+		
+		if (!s_bFocusSettingsCached)
+		{
+			GetGame().OnUserSettingsChangedInvoker().Insert(CacheFocusSettings);
+			s_bFocusSettingsCached = true;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Clients ask for the server's settings as soon as they own their controller.
+	override protected void OnOwnershipChanged(bool changing, bool becameOwner)
+	{
+		super.OnOwnershipChanged(changing, becameOwner);
+		
+		if (!changing && becameOwner && RplSession.Mode() == RplMode.Client)
+			Rpc(RpcAsk_RequestNarcoSettings);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Sends the settings block to every connected client whenever the server's settings are reloaded. Server only.
+	static void WatchForClientSettingsChanges()
+	{
+		NarcoSettingsSnapshot.GetOnPublished().Remove(BroadcastNarcoSettings);
+		NarcoSettingsSnapshot.GetOnPublished().Insert(BroadcastNarcoSettings);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	private static void BroadcastNarcoSettings(NarcoSettingsSnapshot snapshot)
+	{
+		PlayerManager playerManager = GetGame().GetPlayerManager();
+		array<int> playerIds = {};
+		playerManager.GetPlayers(playerIds);
+		
+		foreach (int playerId : playerIds)
+		{
+			SCR_PlayerController playerController = SCR_PlayerController.Cast(playerManager.GetPlayerController(playerId));
+			if (playerController)
+				playerController.SendNarcoSettings(snapshot);
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	protected void SendNarcoSettings(NarcoSettingsSnapshot snapshot)
+	{
+		int header, limits;
+		snapshot.PackClientBlock(header, limits);
+		Rpc(RpcDo_ReceiveNarcoSettings, header, limits, snapshot.m_fRankXPMultiplier, snapshot.m_fZoomDuration, snapshot.m_fZoomCooldown);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	[RplRpc(RplChannel.Reliable, RplRcver.Server)]
+	protected void RpcAsk_RequestNarcoSettings()
+	{
+		SendNarcoSettings(NarcoSettingsSnapshot.Get());
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	[RplRpc(RplChannel.Reliable, RplRcver.Owner)]
+	protected void RpcDo_ReceiveNarcoSettings(int header, int limits, float rankXPMultiplier, float zoomDuration, float zoomCooldown)
+	{
+		NarcoSettingsSnapshot snapshot = NarcoSettingsSnapshot.UnpackClientBlock(header, limits, rankXPMultiplier, zoomDuration, zoomCooldown);
+		if (!snapshot)
+		{
+			Print(string.Format("Narco QOL Mods WARNING: Server sent settings block version %1, expected %2. Keeping the current settings.", header & 0xF, NarcoSettingsSnapshot.CLIENT_BLOCK_VERSION), LogLevel.WARNING);
+			return;
+		}
+		
+		NarcoSettingsSnapshot.PublishReplicated(snapshot);
+		
+		// Re-clamp the user's settings to the new limits and let the camera pick them up.
+		SetGameUserSettings();
+		GetGame().UserSettingsChanged();
 	}
 
 	//------------------------------------------------------------------------------------------------
 	override protected void ActionFocusToggle(float value = 0.0, EActionTrigger reason = 0)
 	{
-		NarcoFovAndZoomSettings settings = NarcoJsonSettingsManager.GetInstance().GetFovAndZoomSettings();
-		if (!settings || !settings.m_bEnabled)
+		NarcoSettingsSnapshot settings = NarcoSettingsSnapshot.Get();
+		if (!settings.m_bFovAndZoomEnabled)
 		{
 			super.ActionFocusToggle(value, reason);
 			return;
@@ -225,22 +312,55 @@ modded class SCR_PlayerController : PlayerController
 // --- Camera Manager Logic ---
 modded class SCR_CameraManager : CameraManager
 {
+	// FOVs from the user settings, refreshed only when the settings change.
+	private float m_fFirstPersonFOV_Cached;
+	private float m_fThirdPersonFOV_Cached;
+	private float m_fVehicleFOV_Cached;
+	private bool m_bFovSettingsCached;
+	
 	//------------------------------------------------------------------------------------------------
 	//! Sets the FOV based on the (now clamped) user settings.
 	override protected void SetupFOV()
 	{
-		BaseContainer fovSettings = GetGame().GetGameUserSettings().GetModule("Narco_FieldOfViewSettings");
-		if (!fovSettings)
+		if (!m_bFovSettingsCached)
+		{
+			CacheFovSettings();
 			return;
+		}
 		
-		float fov;
-		if (fovSettings.Get("m_fFirstPersonFOV", fov))
-			SetFirstPersonFOV(fov);
+		if (m_fFirstPersonFOV_Cached > 0)
+			SetFirstPersonFOV(m_fFirstPersonFOV_Cached);
 		
-		if (fovSettings.Get("m_fThirdPersonFOV", fov))
-			SetThirdPersonFOV(fov);
+		if (m_fThirdPersonFOV_Cached > 0)
+			SetThirdPersonFOV(m_fThirdPersonFOV_Cached);
+		
+		if (m_fVehicleFOV_Cached > 0)
+			SetVehicleFOV(m_fVehicleFOV_Cached);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Copies the FOVs out of the user settings and applies them. Subscribes to later changes on first use.
+	void CacheFovSettings()
+	{
+		m_fFirstPersonFOV_Cached = 0;
+		m_fThirdPersonFOV_Cached = 0;
+		m_fVehicleFOV_Cached = 0;
+		
+		BaseContainer fovSettings = GetGame().GetGameUserSettings().GetModule("Narco_FieldOfViewSettings");
+		if (fovSettings)
+		{
+			fovSettings.Get("m_fFirstPersonFOV", m_fFirstPersonFOV_Cached);
+			fovSettings.Get("m_fThirdPersonFOV", m_fThirdPersonFOV_Cached);
+			fovSettings.Get("m_fVehicleFOV", m_fVehicleFOV_Cached);
+		}
+		
+		if (!m_bFovSettingsCached)
+		{
+			GetGame().OnUserSettingsChangedInvoker().Insert(CacheFovSettings);
+			m_bFovSettingsCached = true;
+		}
 		
-		if (fovSettings.Get("m_fVehicleFOV", fov))
-			SetVehicleFOV(fov);
+		// The change event may have reached SetupFOV() before us, so apply the fresh values here.
+		SetupFOV();
 	}
 }
@@ -3,147 +3,109 @@
 // PURPOSE: Contains all logic for finding and cleaning GUIDs from loadout files.
 // -------------------------------------------------------------------------
 
+// Manifest record of a loadout file as it was after its last clean.
+class LoadoutManifestEntry
+{
+	int m_iSize;
+	int m_iContentHash;
+	int m_iBlocklistVersion;
+}
+
+
+// Cleaning runs as a background job over a bounded number of files per frame. Files are processed in sorted
+// order and the last cleaned path is checkpointed, so a server restart resumes the job instead of starting over.
+// A manifest remembers each file's size, content hash and blocklist version, so unchanged files are only hashed, not rewritten.
 class LoadoutCleaner
 {
+	// Blocked prefab GUIDs are always 16 hex characters.
+	private static const int GUID_LENGTH = 16;
+	private static const string CHECKPOINT_PATH = "$profile:NarcoLoadoutCleaner_Checkpoint.txt";
+	private static const string MANIFEST_PATH = "$profile:NarcoLoadoutCleaner_Manifest.txt";
+	private static const string MANIFEST_DELTA_PATH = "$profile:NarcoLoadoutCleaner_ManifestDelta.txt";
+	private static const string TEMP_SUFFIX = ".tmp";
+	
+	// Files are streamed in chunks. The overlap keeps enough unprocessed text between chunks to hold the longest
+	// match (an escaped prefab reference with its GUID), so tokens split across a chunk boundary are still found.
+	private static const int CHUNK_SIZE = 4096;
+	private static const int CHUNK_OVERLAP = 30;
+	private static const int CHECKPOINT_INTERVAL_FILES = 100;
+	private static const int DEFAULT_FILES_PER_FRAME = 10;
+	private static const string HEX_DIGITS = "0123456789ABCDEF";
+	
+	private static ref set<string> s_BlockedGuids;
+	private static int s_iBlocklistVersion;
+	private static ref map<string, ref LoadoutManifestEntry> s_mManifest;
+	private static ref array<string> s_aManifestDelta = {};
+	
+	// --- Job state ---
+	private static ref array<string> s_aPendingFiles;
+	private static int s_iNextFile;
+	private static int s_iFilesProcessed;
+	private static int s_iFilesUnchanged;
+	private static int s_iFilesSinceCheckpoint;
+	private static int s_iFilesPerFrame;
+	
+	// --- Stream state of the file being cleaned ---
+	private static FileHandle s_StreamOutput;
+	private static string s_sPendingOutput;
+	private static int s_iOutputHash;
+	private static bool s_bStreamModified;
+	
 	// --- Main execution function ---
+	// Starts a fresh cleaning job over all loadout files.
 	static void Run()
 	{
 		Print("Loadout Cleaner: Starting loadout cleaning script...", LogLevel.NORMAL);
+		StartJob("");
+	}
+	
+	// --- Resumes a job interrupted by a server restart. Does nothing if no job was in progress ---
+	static void Resume()
+	{
+		if (IsRunning() || !FileIO.FileExists(CHECKPOINT_PATH))
+			return;
 		
-		array<string> guidsToRemove = new array<string>();
-		guidsToRemove.Insert("FD75A60672D2755B"); // XPS3 + G33 (Red)
-		guidsToRemove.Insert("E24DA10E344E4F9F"); // XPS3 + G33 (FDE/RED)
-		guidsToRemove.Insert("CBEB551860024355"); // XPS3 + G33 (Green)
-		guidsToRemove.Insert("D5CD8E60416F1D5D"); // XPS3 + G33 (FDE/Green)
-		guidsToRemove.Insert("25E734CCFB586A0F"); // Bacon L3 3.5-10x
-		guidsToRemove.Insert("66EACA487953F313"); // Bacon L3 3.5-10x (FDE) 
-		guidsToRemove.Insert("61ECD3C29600A4BC"); // Bacon Specter
-		guidsToRemove.Insert("9717E16AC6D59CC1"); // Bacon Specter (FDE)
-		guidsToRemove.Insert("D0EF24860024D32D"); // Bacon Barrett Scope
-		guidsToRemove.Insert("333A794F0B55C019"); // M8541
-		guidsToRemove.Insert("ACC9B43941CE5EA6"); // Leupold MK4
-		guidsToRemove.Insert("5D6774CB06C4B12B"); // TS30A2
-		guidsToRemove.Insert("31D605AB4386774F"); // TS30A2 (Camo)
-		guidsToRemove.Insert("7FC82F39B98AF906"); // TS30A2 (No Cover)
-		guidsToRemove.Insert("B1C7EEC9ECD85AEC"); // TS30A2 (No Cover/Camo)
-		guidsToRemove.Insert("2518CA6044D6BBDD"); // TA31RCO
-		guidsToRemove.Insert("90A20A1ED92AD477"); // TA31RCO (ARD)
-		guidsToRemove.Insert("30B41A4172CBD098"); // TA31RCO (Army/ARD)
-		guidsToRemove.Insert("50475BC9E6A7ABD0"); // TA31RCO (Army)
-		guidsToRemove.Insert("A28C985454C90D44"); // TA648MDO
-		guidsToRemove.Insert("36EF773EB236A891"); // TA648MDO RMR
-		guidsToRemove.Insert("DA2AED4A5F958164"); // SU230
-		guidsToRemove.Insert("7DB681643152613C"); // SU230 MRDS
-		guidsToRemove.Insert("01BE30D243F577EE2"); // SU230 MRDS (FDE)
-		guidsToRemove.Insert("7A5A21F5F2F508CA"); // SU230 (FDE)
-		guidsToRemove.Insert("48414BA60F3B0DFA"); // FA762SS
-		guidsToRemove.Insert("727AB5567E71B5C9"); // FA762SS (FDE)
-		guidsToRemove.Insert("6188691D38DA6E2D"); // RC2 
-		guidsToRemove.Insert("022D4D7C8DED3412"); // RC2 (FDE)
-		guidsToRemove.Insert("CB2ED665F4671DDA"); // RC3
-		guidsToRemove.Insert("6C607325B88CDA9A"); // RC3 (FDE)
-		guidsToRemove.Insert("7C4C82A5CC86129B"); // Warden
-		guidsToRemove.Insert("EBD2768377E131BE"); // Warden (FDE) 
-		guidsToRemove.Insert("B9C41AAC90570E50"); // NT4 QDS
-		guidsToRemove.Insert("EF8F44E10F9B7A9D"); // NT4 QDS (Covered)
-		guidsToRemove.Insert("B591C94754DB4893"); // NT4 QDS (Covered/Multicam)
-		guidsToRemove.Insert("F3DD3F69F633AD36"); // TGPA
-		guidsToRemove.Insert("18B5482585A88240"); // TGPV2
-		guidsToRemove.Insert("52DE237FDD13DE1B"); // Griffin Armament M4SDII
-		guidsToRemove.Insert("C9CD044ECFA192FC"); // HUXWRX
-		guidsToRemove.Insert("C89678424F8C89FA"); // HUXWRX (FDE)
-		guidsToRemove.Insert("1165F1327B7BA2CE"); // KAC NT4
-		guidsToRemove.Insert("C56196C694BAC33E"); // KAC PRT (Base)
-		guidsToRemove.Insert("AB81D66BD2B2EE28"); // KAC PRT (FDE)
-		guidsToRemove.Insert("B99BC63CAA092616"); // KAC PRT
-		guidsToRemove.Insert("FCFB98B90DE5E63B"); // KAC PRT (Covered)
-		guidsToRemove.Insert("3539B08F067881F5"); // KAC PRT (Covered/FDE)
-		guidsToRemove.Insert("BDFB6F951A40100F"); // KAC PRT MCQ (Base)
-		guidsToRemove.Insert("61D7A15C574B8DB9"); // KAC PRT MCQ
-		guidsToRemove.Insert("7DC3CC4E2BCEA042"); // KAC PRT MCQ (Covered)
-		guidsToRemove.Insert("73CDB10B2FF04587"); // KAC PRT MCQ (FDE)
-		guidsToRemove.Insert("3539B08F067881F5"); // KAC PRT MCQ (Covered/FDE)
-		guidsToRemove.Insert("05D8008A7A689D2A"); // RC2
-		guidsToRemove.Insert("592DF768C2903A6C"); // RC2 (FDE)
-		guidsToRemove.Insert("B557C022319FA38D"); // DD Wave
-		guidsToRemove.Insert("58FE43441C176CBC"); // Gemtech ONE
-		guidsToRemove.Insert("80CF4AAD6F2C9938"); // KAC PRS
-		guidsToRemove.Insert("B57EBA12EBB68348"); // SDN6
-		guidsToRemove.Insert("DD71997306E60BD3"); // SDN6 (FDE)
-		guidsToRemove.Insert("935A383CAA0438DB"); // SRD762
-        guidsToRemove.Insert("E5BDE3E05332677B"); // SRD9
-        guidsToRemove.Insert("B26165A1B7F96CAF"); // G28 Suppressor
-        guidsToRemove.Insert("8B6FAA4440BC6083"); // M200 Suppressor
-        guidsToRemove.Insert("9965CFA74E3BDD30"); // M200 Suppressor (FDE)
-		guidsToRemove.Insert("A1E1A91C0A85DC2D"); // TBA Ultra 5
-		guidsToRemove.Insert("EA6F06C62661AEDE"); // DTK Putnik (Base)
-		guidsToRemove.Insert("1FFA2EAB58BCC734"); // DTK Putnik
-		guidsToRemove.Insert("BF311994BCAC898C"); // DTK Putnik (FDE)
-		guidsToRemove.Insert("D71A2C599DC587FE"); // DTK Putnik (White)
-		guidsToRemove.Insert("3832C568BB5D133B"); // PBS1
-		guidsToRemove.Insert("42CFE1F3146CF243"); // SVU Suppressor
-		guidsToRemove.Insert("94909AABD52A245E"); // SR3M Suppressor
-		guidsToRemove.Insert("695AAA77F84EB238"); // 1P21
-		guidsToRemove.Insert("A1D5833FF10C6503"); // PSO1 M2-1
-		guidsToRemove.Insert("C850A33226B8F9C1"); // PSO1
-		guidsToRemove.Insert("198552B5E566581D"); // Elcan OS4x
-		guidsToRemove.Insert("5F7D782D70C0CD77"); // Elcan OS4x RMR
-        guidsToRemove.Insert("C92124661FAAD572"); // Vudu (Base)
-		guidsToRemove.Insert("4E7A2327E3D21B17"); // Vudu
-		guidsToRemove.Insert("259C731C32A0A85D"); // Vudu RMR
-		guidsToRemove.Insert("5C6033709B69D329"); // Vudu (FDE)
-		guidsToRemove.Insert("C8932D3FAC122095"); // Vudu RMR (FDE)
-		guidsToRemove.Insert("8DE134EF86802168"); // Vudu RMR (9x39)
-		guidsToRemove.Insert("046AC4ECD9EC0277"); // HAMR
-		guidsToRemove.Insert("05CA01CADBF835B2"); // ATACR 1-8
-		guidsToRemove.Insert("81C59864732DE2BF"); // ATACR 1-8 RMR
-		guidsToRemove.Insert("8C0953E51C217AC9"); // ATACR 4-16
-		guidsToRemove.Insert("92F5B7DB1341E741"); // ATACR 4-16 RMR
-		guidsToRemove.Insert("51B7A08626B547BE"); // NPZ PO156x
-		guidsToRemove.Insert("2B9211E18D22D7DF"); // NPZ PSU 1-4x
-		guidsToRemove.Insert("84DCE6233EA7B471"); // Pilad Brevis
-		guidsToRemove.Insert("96C6F674461C7C4F"); // Pilad Brevis (FDE)
-		guidsToRemove.Insert("0481183D215F2D7B"); // Razor
-		guidsToRemove.Insert("C616145F2710F517"); // Razor RMR
-		guidsToRemove.Insert("FEB6FAF2E96EF992"); // PM2 1-8 (Base)
-		guidsToRemove.Insert("DE9FF9BBFA43F338"); // PM2 1-8 RMR
-		guidsToRemove.Insert("B9B41B89CCC52A7C"); // PM2 3-20 (Base)
-		guidsToRemove.Insert("A4FE1585FDD46B9F"); // PM2 3-20 H2
-		guidsToRemove.Insert("E9E4B001C12E71F8"); // PMII 5-25
-		guidsToRemove.Insert("9553BF61AAA59B97"); // PMII 5-25 FDE
-		guidsToRemove.Insert("92450FA425FBCE7F"); // Elcan SpecterDR (Base/FDE)
-		guidsToRemove.Insert("E3D28C1345FC2D85"); // Elcan SpecterDR
-		guidsToRemove.Insert("2317FC3B9E8BD064"); // Elcan SpecterDR RMR (FDE)
-		guidsToRemove.Insert("BEDA88B88A067248"); // Elcan SpecterDR RMR
-		guidsToRemove.Insert("69C3780699DCDF0D"); // Tango6T
-		guidsToRemove.Insert("D0E1AC91F56EDF8A"); // Tango6T RMR
-		guidsToRemove.Insert("7BD96851E1671733"); // Tango6T (FDE)
-		guidsToRemove.Insert("5279254DC7119EE9"); // Tango6T RMR (FDE)
-		guidsToRemove.Insert("546A3F976ED4789B"); // TA31 RMR
-		guidsToRemove.Insert("6080874CFDB25EB6"); // TA31 RMR (ARD)
-		guidsToRemove.Insert("4966125BA4DE7AC4"); // TA31 RMR (ARD/FDE)
-		guidsToRemove.Insert("C32141FF292E6A77"); // TA31 RMR (ARD/Green)
-		guidsToRemove.Insert("FCBE6EFA75E5DC87"); // TA31 RMR (ARD/Yellow)
-		guidsToRemove.Insert("D8F0BBA1F8A74CA6"); // TA31 RMR (FDE)
-		guidsToRemove.Insert("EA4EC32B3DB20312"); // TA31 RMR (Green)
-		guidsToRemove.Insert("D5D1EC2E6179B5E2"); // TA31 RMR (Yellow)
-		guidsToRemove.Insert("92312833FD7DA7DB"); // Eleanor ACRO (FDE)
-		guidsToRemove.Insert("802B386485C66FE5"); // Eleanor ACRO
-		guidsToRemove.Insert("45D5B9B53B3B4C66"); // Eleanor 
-		guidsToRemove.Insert("57CFA9E243808458"); // Eleanor (FDE)
-		guidsToRemove.Insert("30AB1B2624B5843B"); // Micro T2 + Magnifier
-		guidsToRemove.Insert("22B10B715C0E4C05"); // Micro T2 + Magnifier (FDE)
-		guidsToRemove.Insert("3158264E43B14C07"); // EXPS3 G33
-		guidsToRemove.Insert("234236193B0A8439"); // EXPS3 G33 (FDE)
-		guidsToRemove.Insert("E8A55396050E1762"); // RPG PGO7
-		guidsToRemove.Insert("DF64F75C84B426A6"); // RPG 7
-		guidsToRemove.Insert("85045DE3DD639F40"); // RPG 72
-		guidsToRemove.Insert("DA376E83952F1DFD"); // M2 Carl Gustaf
-		guidsToRemove.Insert("962C400354E4BD6C"); // Igla
-		guidsToRemove.Insert("3DF204EEE0534EF2"); // Stinger
-		guidsToRemove.Insert("4A3B196E4EA820E9"); // OG7V
-        guidsToRemove.Insert("FBBF84E3B447D822"); // PG7VL
-        guidsToRemove.Insert("86A7681BD1D4E4BB"); // PG7VR
+		string lastCleanedPath;
+		FileHandle checkpoint = FileIO.OpenFile(CHECKPOINT_PATH, FileMode.READ);
+		if (checkpoint)
+		{
+			checkpoint.ReadLine(lastCleanedPath);
+			checkpoint.Close();
+		}
+		
+		Print(string.Format("Loadout Cleaner: Resuming interrupted loadout cleaning after '%1'.", lastCleanedPath), LogLevel.NORMAL);
+		StartJob(lastCleanedPath);
+	}
+	
+	// --- Returns true while the background job has files left ---
+	static bool IsRunning()
+	{
+		return s_aPendingFiles != null;
+	}
+	
+	// --- Cleans a player's own loadout files right away, ahead of the background job ---
+	// Loadout files are named after the player's identity, so this runs before the player can load one.
+	static void CleanPlayerFiles(string identityId)
+	{
+		if (!IsRunning() || identityId.IsEmpty())
+			return;
+		
+		for (int i = s_aPendingFiles.Count() - 1; i >= s_iNextFile; i--)
+		{
+			string path = s_aPendingFiles[i];
+			if (!FilePath.StripPath(path).Contains(identityId))
+				continue;
+			
+			CleanFile(path);
+			s_aPendingFiles.RemoveOrdered(i);
+			s_iFilesProcessed++;
+		}
+	}
+	
+	// --- Collects the files to clean and starts processing them over the following frames ---
+	private static void StartJob(string lastCleanedPath)
+	{
+		GetBlockedGuids();
 		
 		array<string> loadoutPaths = {
 			"$profile:BaconLoadoutEditor_Loadouts/1.3/",
@@ -160,64 +122,761 @@ class LoadoutCleaner
 		}
 
 		Print(string.Format("Loadout Cleaner: Found %1 total paths to check across all mods.", allFoundPaths.Count()), LogLevel.NORMAL);
-
-		int filesProcessed = 0;
+		
+		// Sorted, so the checkpoint (last cleaned path) marks a stable position across restarts.
+		s_aPendingFiles = {};
 		foreach (string path : allFoundPaths)
 		{
-			string fileName = FilePath.StripPath(path);
-			if (fileName.Contains("-"))
+			if (!FilePath.StripPath(path).Contains("-"))
+				continue;
+			
+			if (!lastCleanedPath.IsEmpty() && path.Compare(lastCleanedPath) <= 0)
+				continue;
+			
+			s_aPendingFiles.Insert(path);
+		}
+		
+		s_aPendingFiles.Sort();
+		s_iNextFile = 0;
+		s_iFilesProcessed = 0;
+		s_iFilesUnchanged = 0;
+		
+		if (!s_mManifest)
+			LoadManifest();
+		
+		// A fresh run sees every file, so entries of deleted files can go.
+		if (lastCleanedPath.IsEmpty())
+		{
+			map<string, ref LoadoutManifestEntry> manifest = new map<string, ref LoadoutManifestEntry>();
+			foreach (string pendingPath : s_aPendingFiles)
 			{
-				ProcessLoadoutFile(path, guidsToRemove);
-				filesProcessed++;
+				LoadoutManifestEntry entry = s_mManifest.Get(pendingPath);
+				if (entry)
+					manifest.Set(pendingPath, entry);
 			}
+			
+			s_mManifest = manifest;
 		}
-
-		Print(string.Format("Loadout Cleaner: Finished. Processed %1 valid files.", filesProcessed), LogLevel.NORMAL);
+		s_iFilesSinceCheckpoint = 0;
+		
+		s_iFilesPerFrame = NarcoJsonSettingsManager.GetInstance().GetPersistentRankSettings().m_iLoadoutCleaningFilesPerFrame;
+		if (s_iFilesPerFrame <= 0)
+			s_iFilesPerFrame = DEFAULT_FILES_PER_FRAME;
+		
+		WriteCheckpoint(lastCleanedPath);
+		GetGame().GetCallqueue().Remove(ProcessPendingFiles);
+		GetGame().GetCallqueue().CallLater(ProcessPendingFiles, 0, true);
 	}
-
-	// --- Processes a single player loadout file ---
-	private static void ProcessLoadoutFile(string filePath, array<string> guidsToRemove)
+	
+	// --- Called every frame while the job is running. Cleans at most the configured number of files ---
+	private static void ProcessPendingFiles()
 	{
-		string fileContent = SCR_FileIOHelper.GetFileStringContent(filePath);
-		if (fileContent.IsEmpty())
+		int lastFile = Math.Min(s_iNextFile + s_iFilesPerFrame, s_aPendingFiles.Count());
+		while (s_iNextFile < lastFile)
+		{
+			CleanFile(s_aPendingFiles[s_iNextFile]);
+			s_iNextFile++;
+			s_iFilesProcessed++;
+			s_iFilesSinceCheckpoint++;
+		}
+		
+		if (s_iNextFile >= s_aPendingFiles.Count())
+		{
+			FinishJob();
 			return;
-
-		string originalFileContent = fileContent;
+		}
 		
-		string escapedQuote = SCR_StringHelper.ANTISLASH + SCR_StringHelper.DOUBLE_QUOTE;
-		string searchPatternCore = escapedQuote + "prefab" + escapedQuote + ":";
-		string replacePatternCore = searchPatternCore + escapedQuote + escapedQuote;
+		if (s_iFilesSinceCheckpoint >= CHECKPOINT_INTERVAL_FILES)
+		{
+			WriteCheckpoint(s_aPendingFiles[s_iNextFile - 1]);
+			s_iFilesSinceCheckpoint = 0;
+		}
+	}
+	
+	// --- Stops the job and removes the checkpoint ---
+	// The full manifest is only written here. It replaces the deltas appended at the checkpoints.
+	private static void FinishJob()
+	{
+		GetGame().GetCallqueue().Remove(ProcessPendingFiles);
+		if (SaveManifest())
+		{
+			s_aManifestDelta.Clear();
+			FileIO.DeleteFile(MANIFEST_DELTA_PATH);
+		}
+		else
+		{
+			AppendManifestDelta();
+		}
+		
+		FileIO.DeleteFile(CHECKPOINT_PATH);
+		Print(string.Format("Loadout Cleaner: Finished. Processed %1 valid files, %2 unchanged since their last clean.", s_iFilesProcessed, s_iFilesUnchanged), LogLevel.NORMAL);
+		
+		s_aPendingFiles = null;
+	}
+	
+	// --- Stores the last cleaned path. An existing checkpoint means a job is in progress ---
+	// The manifest entries changed since the last checkpoint are appended first, so the manifest never claims more than the checkpoint.
+	private static void WriteCheckpoint(string lastCleanedPath)
+	{
+		AppendManifestDelta();
+		
+		FileHandle checkpoint = FileIO.OpenFile(CHECKPOINT_PATH, FileMode.WRITE);
+		if (!checkpoint)
+		{
+			Print("Loadout Cleaner ERROR: Failed to write cleaning checkpoint.", LogLevel.ERROR);
+			return;
+		}
+		
+		checkpoint.WriteLine(lastCleanedPath);
+		checkpoint.Close();
+	}
+	
+	// --- Cleans a file unless the manifest shows it hasn't changed since it was cleaned against the current blocklist ---
+	// FileIO has no modification times, so a different size is the only check that needs no read. A matching size
+	// proves nothing (swapping one GUID for another keeps it), so such a file is hashed in full before it is skipped.
+	// Reads therefore still grow with the archive; what the manifest saves is the temp file and the rewrite.
+	private static void CleanFile(string filePath)
+	{
+		FileHandle file = FileIO.OpenFile(filePath, FileMode.READ);
+		if (!file)
+			return;
+		
+		int fileSize = file.GetLength();
+		LoadoutManifestEntry entry = s_mManifest.Get(filePath);
+		bool manifestMatches = entry && entry.m_iSize == fileSize && entry.m_iBlocklistVersion == s_iBlocklistVersion;
+		
+		int unchangedHash;
+		if (manifestMatches)
+			unchangedHash = HashFile(file);
+		
+		file.Close();
+		
+		if (manifestMatches && entry.m_iContentHash == unchangedHash)
+		{
+			s_iFilesUnchanged++;
+			return;
+		}
+		
+		int contentHash;
+		bool modified;
+		if (!ProcessLoadoutFile(filePath, s_BlockedGuids, contentHash, modified))
+			return;
+		
+		if (modified)
+			fileSize = GetFileSize(filePath);
+		
+		if (!entry)
+		{
+			entry = new LoadoutManifestEntry();
+			s_mManifest.Set(filePath, entry);
+		}
+		
+		entry.m_iSize = fileSize;
+		entry.m_iContentHash = contentHash;
+		entry.m_iBlocklistVersion = s_iBlocklistVersion;
+		s_aManifestDelta.Insert(filePath);
+	}
+	
+	// --- Returns the content hash of an open file, hashed chunk by chunk the same way ProcessLoadoutFile hashes its output ---
+	private static int HashFile(FileHandle file)
+	{
+		int contentHash = 0;
+		string chunk;
+		while (file.Read(chunk, CHUNK_SIZE) > 0)
+		{
+			contentHash = contentHash * 31 + chunk.Hash();
+		}
+		
+		return contentHash;
+	}
+	
+	// --- Returns the size of a file in bytes, or -1 if it can't be opened ---
+	private static int GetFileSize(string filePath)
+	{
+		FileHandle file = FileIO.OpenFile(filePath, FileMode.READ);
+		if (!file)
+			return -1;
+		
+		int fileSize = file.GetLength();
+		file.Close();
+		return fileSize;
+	}
+	
+	// --- Reads the manifest, then the deltas of an interrupted job on top of it ---
+	private static void LoadManifest()
+	{
+		s_mManifest = new map<string, ref LoadoutManifestEntry>();
+		ReadManifestFile(MANIFEST_PATH);
+		ReadManifestFile(MANIFEST_DELTA_PATH);
+	}
+	
+	// --- Reads manifest lines into the manifest. Lines hold path, size, content hash and blocklist version, separated by tabs ---
+	// Later lines for the same path replace earlier ones.
+	private static void ReadManifestFile(string manifestPath)
+	{
+		if (!FileIO.FileExists(manifestPath))
+			return;
+		
+		FileHandle manifest = FileIO.OpenFile(manifestPath, FileMode.READ);
+		if (!manifest)
+			return;
+		
+		string line;
+		array<string> fields = {};
+		while (manifest.ReadLine(line) >= 0)
+		{
+			fields.Clear();
+			line.Split("\t", fields, false);
+			if (fields.Count() != 4)
+				continue;
+			
+			LoadoutManifestEntry entry = new LoadoutManifestEntry();
+			entry.m_iSize = fields[1].ToInt();
+			entry.m_iContentHash = fields[2].ToInt();
+			entry.m_iBlocklistVersion = fields[3].ToInt();
+			s_mManifest.Set(fields[0], entry);
+		}
+		
+		manifest.Close();
+	}
+	
+	// --- Writes the manifest ---
+	private static bool SaveManifest()
+	{
+		if (!s_mManifest)
+			return false;
+		
+		FileHandle manifest = FileIO.OpenFile(MANIFEST_PATH, FileMode.WRITE);
+		if (!manifest)
+		{
+			Print("Loadout Cleaner ERROR: Failed to write cleaning manifest.", LogLevel.ERROR);
+			return false;
+		}
+		
+		foreach (string path, LoadoutManifestEntry entry : s_mManifest)
+		{
+			WriteManifestLine(manifest, path, entry);
+		}
+		
+		manifest.Close();
+		return true;
+	}
+	
+	// --- Appends the entries changed since the last checkpoint, so a checkpoint costs the churn, not the whole manifest ---
+	private static void AppendManifestDelta()
+	{
+		if (s_aManifestDelta.IsEmpty())
+			return;
+		
+		FileHandle delta = FileIO.OpenFile(MANIFEST_DELTA_PATH, FileMode.APPEND);
+		if (!delta)
+		{
+			Print("Loadout Cleaner ERROR: Failed to append to the cleaning manifest.", LogLevel.ERROR);
+			return;
+		}
+		
+		foreach (string path : s_aManifestDelta)
+		{
+			LoadoutManifestEntry entry = s_mManifest.Get(path);
+			if (entry)
+				WriteManifestLine(delta, path, entry);
+		}
+		
+		delta.Close();
+		s_aManifestDelta.Clear();
+	}
+	
+	// --- Writes one manifest line ---
+	private static void WriteManifestLine(FileHandle manifest, string path, LoadoutManifestEntry entry)
+	{
+		manifest.WriteLine(path + "\t" + entry.m_iSize.ToString() + "\t" + entry.m_iContentHash.ToString() + "\t" + entry.m_iBlocklistVersion.ToString());
+	}
+	
+	// --- Returns the validated blocklist, compiling it from the settings on first use ---
+	static set<string> GetBlockedGuids()
+	{
+		if (!s_BlockedGuids)
+			SetBlocklist(CompileBlocklist(NarcoJsonSettingsManager.GetInstance().GetLoadoutCleanerSettings()));
+		
+		return s_BlockedGuids;
+	}
+	
+	// --- Removes every blocked item carried by a freshly spawned character, attachments included ---
+	// Returns the number of removed items. Only the spawning player's own entities are visited, so the cost
+	// scales with active players instead of stored loadout files.
+	static int SanitizeSpawnedEntity(IEntity character)
+	{
+		set<string> blockedGuids = GetBlockedGuids();
+		if (!character || blockedGuids.IsEmpty())
+			return 0;
+		
+		array<IEntity> blockedItems = {};
+		CollectBlockedItems(character, blockedGuids, blockedItems);
+		if (blockedItems.IsEmpty())
+			return 0;
+		
+		InventoryStorageManagerComponent storageManager = InventoryStorageManagerComponent.Cast(character.FindComponent(InventoryStorageManagerComponent));
+		foreach (IEntity item : blockedItems)
+		{
+			if (!item)
+				continue;
+			
+			if (!storageManager || !storageManager.TryDeleteItem(item))
+				SCR_EntityHelper.DeleteEntityAndChildren(item);
+		}
+		
+		return blockedItems.Count();
+	}
+	
+	// --- Recompiles the blocklist whenever the config file is reloaded ---
+	static void WatchForBlocklistChanges()
+	{
+		NarcoSettingsSnapshot.GetOnPublished().Remove(OnSettingsPublished);
+		NarcoSettingsSnapshot.GetOnPublished().Insert(OnSettingsPublished);
+	}
+	
+	// --- Fills a blocklist with the built-in blocked prefabs. Used to seed the config ---
+	static void AddDefaultBlockedPrefabs(notnull array<ref NarcoBlockedPrefab> blockedPrefabs)
+	{
+		AddBlockedPrefab(blockedPrefabs, "FD75A60672D2755B", "XPS3 + G33 (Red)");
+		AddBlockedPrefab(blockedPrefabs, "E24DA10E344E4F9F", "XPS3 + G33 (FDE/RED)");
+		AddBlockedPrefab(blockedPrefabs, "CBEB551860024355", "XPS3 + G33 (Green)");
+		AddBlockedPrefab(blockedPrefabs, "D5CD8E60416F1D5D", "XPS3 + G33 (FDE/Green)");
+		AddBlockedPrefab(blockedPrefabs, "25E734CCFB586A0F", "Bacon L3 3.5-10x");
+		AddBlockedPrefab(blockedPrefabs, "66EACA487953F313", "Bacon L3 3.5-10x (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "61ECD3C29600A4BC", "Bacon Specter");
+		AddBlockedPrefab(blockedPrefabs, "9717E16AC6D59CC1", "Bacon Specter (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "D0EF24860024D32D", "Bacon Barrett Scope");
+		AddBlockedPrefab(blockedPrefabs, "333A794F0B55C019", "M8541");
+		AddBlockedPrefab(blockedPrefabs, "ACC9B43941CE5EA6", "Leupold MK4");
+		AddBlockedPrefab(blockedPrefabs, "5D6774CB06C4B12B", "TS30A2");
+		AddBlockedPrefab(blockedPrefabs, "31D605AB4386774F", "TS30A2 (Camo)");
+		AddBlockedPrefab(blockedPrefabs, "7FC82F39B98AF906", "TS30A2 (No Cover)");
+		AddBlockedPrefab(blockedPrefabs, "B1C7EEC9ECD85AEC", "TS30A2 (No Cover/Camo)");
+		AddBlockedPrefab(blockedPrefabs, "2518CA6044D6BBDD", "TA31RCO");
+		AddBlockedPrefab(blockedPrefabs, "90A20A1ED92AD477", "TA31RCO (ARD)");
+		AddBlockedPrefab(blockedPrefabs, "30B41A4172CBD098", "TA31RCO (Army/ARD)");
+		AddBlockedPrefab(blockedPrefabs, "50475BC9E6A7ABD0", "TA31RCO (Army)");
+		AddBlockedPrefab(blockedPrefabs, "A28C985454C90D44", "TA648MDO");
+		AddBlockedPrefab(blockedPrefabs, "36EF773EB236A891", "TA648MDO RMR");
+		AddBlockedPrefab(blockedPrefabs, "DA2AED4A5F958164", "SU230");
+		AddBlockedPrefab(blockedPrefabs, "7DB681643152613C", "SU230 MRDS");
+		AddBlockedPrefab(blockedPrefabs, "7A5A21F5F2F508CA", "SU230 (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "48414BA60F3B0DFA", "FA762SS");
+		AddBlockedPrefab(blockedPrefabs, "727AB5567E71B5C9", "FA762SS (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "6188691D38DA6E2D", "RC2");
+		AddBlockedPrefab(blockedPrefabs, "022D4D7C8DED3412", "RC2 (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "CB2ED665F4671DDA", "RC3");
+		AddBlockedPrefab(blockedPrefabs, "6C607325B88CDA9A", "RC3 (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "7C4C82A5CC86129B", "Warden");
+		AddBlockedPrefab(blockedPrefabs, "EBD2768377E131BE", "Warden (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "B9C41AAC90570E50", "NT4 QDS");
+		AddBlockedPrefab(blockedPrefabs, "EF8F44E10F9B7A9D", "NT4 QDS (Covered)");
+		AddBlockedPrefab(blockedPrefabs, "B591C94754DB4893", "NT4 QDS (Covered/Multicam)");
+		AddBlockedPrefab(blockedPrefabs, "F3DD3F69F633AD36", "TGPA");
+		AddBlockedPrefab(blockedPrefabs, "18B5482585A88240", "TGPV2");
+		AddBlockedPrefab(blockedPrefabs, "52DE237FDD13DE1B", "Griffin Armament M4SDII");
+		AddBlockedPrefab(blockedPrefabs, "C9CD044ECFA192FC", "HUXWRX");
+		AddBlockedPrefab(blockedPrefabs, "C89678424F8C89FA", "HUXWRX (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "1165F1327B7BA2CE", "KAC NT4");
+		AddBlockedPrefab(blockedPrefabs, "C56196C694BAC33E", "KAC PRT (Base)");
+		AddBlockedPrefab(blockedPrefabs, "AB81D66BD2B2EE28", "KAC PRT (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "B99BC63CAA092616", "KAC PRT");
+		AddBlockedPrefab(blockedPrefabs, "FCFB98B90DE5E63B", "KAC PRT (Covered)");
+		AddBlockedPrefab(blockedPrefabs, "3539B08F067881F5", "KAC PRT (Covered/FDE)");
+		AddBlockedPrefab(blockedPrefabs, "BDFB6F951A40100F", "KAC PRT MCQ (Base)");
+		AddBlockedPrefab(blockedPrefabs, "61D7A15C574B8DB9", "KAC PRT MCQ");
+		AddBlockedPrefab(blockedPrefabs, "7DC3CC4E2BCEA042", "KAC PRT MCQ (Covered)");
+		AddBlockedPrefab(blockedPrefabs, "73CDB10B2FF04587", "KAC PRT MCQ (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "05D8008A7A689D2A", "RC2");
+		AddBlockedPrefab(blockedPrefabs, "592DF768C2903A6C", "RC2 (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "B557C022319FA38D", "DD Wave");
+		AddBlockedPrefab(blockedPrefabs, "58FE43441C176CBC", "Gemtech ONE");
+		AddBlockedPrefab(blockedPrefabs, "80CF4AAD6F2C9938", "KAC PRS");
+		AddBlockedPrefab(blockedPrefabs, "B57EBA12EBB68348", "SDN6");
+		AddBlockedPrefab(blockedPrefabs, "DD71997306E60BD3", "SDN6 (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "935A383CAA0438DB", "SRD762");
+		AddBlockedPrefab(blockedPrefabs, "E5BDE3E05332677B", "SRD9");
+		AddBlockedPrefab(blockedPrefabs, "B26165A1B7F96CAF", "G28 Suppressor");
+		AddBlockedPrefab(blockedPrefabs, "8B6FAA4440BC6083", "M200 Suppressor");
+		AddBlockedPrefab(blockedPrefabs, "9965CFA74E3BDD30", "M200 Suppressor (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "A1E1A91C0A85DC2D", "TBA Ultra 5");
+		AddBlockedPrefab(blockedPrefabs, "EA6F06C62661AEDE", "DTK Putnik (Base)");
+		AddBlockedPrefab(blockedPrefabs, "1FFA2EAB58BCC734", "DTK Putnik");
+		AddBlockedPrefab(blockedPrefabs, "BF311994BCAC898C", "DTK Putnik (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "D71A2C599DC587FE", "DTK Putnik (White)");
+		AddBlockedPrefab(blockedPrefabs, "3832C568BB5D133B", "PBS1");
+		AddBlockedPrefab(blockedPrefabs, "42CFE1F3146CF243", "SVU Suppressor");
+		AddBlockedPrefab(blockedPrefabs, "94909AABD52A245E", "SR3M Suppressor");
+		AddBlockedPrefab(blockedPrefabs, "695AAA77F84EB238", "1P21");
+		AddBlockedPrefab(blockedPrefabs, "A1D5833FF10C6503", "PSO1 M2-1");
+		AddBlockedPrefab(blockedPrefabs, "C850A33226B8F9C1", "PSO1");
+		AddBlockedPrefab(blockedPrefabs, "198552B5E566581D", "Elcan OS4x");
+		AddBlockedPrefab(blockedPrefabs, "5F7D782D70C0CD77", "Elcan OS4x RMR");
+		AddBlockedPrefab(blockedPrefabs, "C92124661FAAD572", "Vudu (Base)");
+		AddBlockedPrefab(blockedPrefabs, "4E7A2327E3D21B17", "Vudu");
+		AddBlockedPrefab(blockedPrefabs, "259C731C32A0A85D", "Vudu RMR");
+		AddBlockedPrefab(blockedPrefabs, "5C6033709B69D329", "Vudu (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "C8932D3FAC122095", "Vudu RMR (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "8DE134EF86802168", "Vudu RMR (9x39)");
+		AddBlockedPrefab(blockedPrefabs, "046AC4ECD9EC0277", "HAMR");
+		AddBlockedPrefab(blockedPrefabs, "05CA01CADBF835B2", "ATACR 1-8");
+		AddBlockedPrefab(blockedPrefabs, "81C59864732DE2BF", "ATACR 1-8 RMR");
+		AddBlockedPrefab(blockedPrefabs, "8C0953E51C217AC9", "ATACR 4-16");
+		AddBlockedPrefab(blockedPrefabs, "92F5B7DB1341E741", "ATACR 4-16 RMR");
+		AddBlockedPrefab(blockedPrefabs, "51B7A08626B547BE", "NPZ PO156x");
+		AddBlockedPrefab(blockedPrefabs, "2B9211E18D22D7DF", "NPZ PSU 1-4x");
+		AddBlockedPrefab(blockedPrefabs, "84DCE6233EA7B471", "Pilad Brevis");
+		AddBlockedPrefab(blockedPrefabs, "96C6F674461C7C4F", "Pilad Brevis (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "0481183D215F2D7B", "Razor");
+		AddBlockedPrefab(blockedPrefabs, "C616145F2710F517", "Razor RMR");
+		AddBlockedPrefab(blockedPrefabs, "FEB6FAF2E96EF992", "PM2 1-8 (Base)");
+		AddBlockedPrefab(blockedPrefabs, "DE9FF9BBFA43F338", "PM2 1-8 RMR");
+		AddBlockedPrefab(blockedPrefabs, "B9B41B89CCC52A7C", "PM2 3-20 (Base)");
+		AddBlockedPrefab(blockedPrefabs, "A4FE1585FDD46B9F", "PM2 3-20 H2");
+		AddBlockedPrefab(blockedPrefabs, "E9E4B001C12E71F8", "PMII 5-25");
+		AddBlockedPrefab(blockedPrefabs, "9553BF61AAA59B97", "PMII 5-25 FDE");
+		AddBlockedPrefab(blockedPrefabs, "92450FA425FBCE7F", "Elcan SpecterDR (Base/FDE)");
+		AddBlockedPrefab(blockedPrefabs, "E3D28C1345FC2D85", "Elcan SpecterDR");
+		AddBlockedPrefab(blockedPrefabs, "2317FC3B9E8BD064", "Elcan SpecterDR RMR (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "BEDA88B88A067248", "Elcan SpecterDR RMR");
+		AddBlockedPrefab(blockedPrefabs, "69C3780699DCDF0D", "Tango6T");
+		AddBlockedPrefab(blockedPrefabs, "D0E1AC91F56EDF8A", "Tango6T RMR");
+		AddBlockedPrefab(blockedPrefabs, "7BD96851E1671733", "Tango6T (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "5279254DC7119EE9", "Tango6T RMR (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "546A3F976ED4789B", "TA31 RMR");
+		AddBlockedPrefab(blockedPrefabs, "6080874CFDB25EB6", "TA31 RMR (ARD)");
+		AddBlockedPrefab(blockedPrefabs, "4966125BA4DE7AC4", "TA31 RMR (ARD/FDE)");
+		AddBlockedPrefab(blockedPrefabs, "C32141FF292E6A77", "TA31 RMR (ARD/Green)");
+		AddBlockedPrefab(blockedPrefabs, "FCBE6EFA75E5DC87", "TA31 RMR (ARD/Yellow)");
+		AddBlockedPrefab(blockedPrefabs, "D8F0BBA1F8A74CA6", "TA31 RMR (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "EA4EC32B3DB20312", "TA31 RMR (Green)");
+		AddBlockedPrefab(blockedPrefabs, "D5D1EC2E6179B5E2", "TA31 RMR (Yellow)");
+		AddBlockedPrefab(blockedPrefabs, "92312833FD7DA7DB", "Eleanor ACRO (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "802B386485C66FE5", "Eleanor ACRO");
+		AddBlockedPrefab(blockedPrefabs, "45D5B9B53B3B4C66", "Eleanor");
+		AddBlockedPrefab(blockedPrefabs, "57CFA9E243808458", "Eleanor (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "30AB1B2624B5843B", "Micro T2 + Magnifier");
+		AddBlockedPrefab(blockedPrefabs, "22B10B715C0E4C05", "Micro T2 + Magnifier (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "3158264E43B14C07", "EXPS3 G33");
+		AddBlockedPrefab(blockedPrefabs, "234236193B0A8439", "EXPS3 G33 (FDE)");
+		AddBlockedPrefab(blockedPrefabs, "E8A55396050E1762", "RPG PGO7");
+		AddBlockedPrefab(blockedPrefabs, "DF64F75C84B426A6", "RPG 7");
+		AddBlockedPrefab(blockedPrefabs, "85045DE3DD639F40", "RPG 72");
+		AddBlockedPrefab(blockedPrefabs, "DA376E83952F1DFD", "M2 Carl Gustaf");
+		AddBlockedPrefab(blockedPrefabs, "962C400354E4BD6C", "Igla");
+		AddBlockedPrefab(blockedPrefabs, "3DF204EEE0534EF2", "Stinger");
+		AddBlockedPrefab(blockedPrefabs, "4A3B196E4EA820E9", "OG7V");
+		AddBlockedPrefab(blockedPrefabs, "FBBF84E3B447D822", "PG7VL");
+		AddBlockedPrefab(blockedPrefabs, "86A7681BD1D4E4BB", "PG7VR");
+	}
+	
+	// --- Applies the blocklist of a reloaded config ---
+	private static void OnSettingsPublished(NarcoSettingsSnapshot snapshot)
+	{
+		// Not compiled yet, the first use picks up the new list anyway.
+		if (!s_BlockedGuids)
+			return;
+		
+		// A running job picks up the new set for its remaining files.
+		int previousVersion = s_iBlocklistVersion;
+		SetBlocklist(CompileBlocklist(NarcoJsonSettingsManager.GetInstance().GetLoadoutCleanerSettings()));
+		if (s_iBlocklistVersion != previousVersion)
+			Print(string.Format("Loadout Cleaner: Blocklist reloaded, %1 prefabs blocked.", s_BlockedGuids.Count()), LogLevel.NORMAL);
+	}
+	
+	// --- Makes a compiled blocklist current. Its version is a hash of the sorted GUIDs, so it only changes with the content ---
+	private static void SetBlocklist(set<string> blockedGuids)
+	{
+		array<string> sortedGuids = {};
+		foreach (string guid : blockedGuids)
+		{
+			sortedGuids.Insert(guid);
+		}
 		
-		foreach (string guid : guidsToRemove)
+		sortedGuids.Sort();
+		s_BlockedGuids = blockedGuids;
+		s_iBlocklistVersion = SCR_StringHelper.Join(",", sortedGuids).Hash();
+	}
+	
+	// --- Builds the set of blocked prefab GUIDs ---
+	// Entries are upper-cased and must be 16 hex characters. Invalid entries and duplicates are skipped with a warning.
+	private static set<string> CompileBlocklist(NarcoLoadoutCleanerSettings settings)
+	{
+		set<string> blockedGuids = new set<string>();
+		if (!settings || !settings.m_aBlockedPrefabs)
+			return blockedGuids;
+		
+		foreach (NarcoBlockedPrefab blockedPrefab : settings.m_aBlockedPrefabs)
 		{
-			string searchPattern = searchPatternCore + escapedQuote + guid + escapedQuote;
-			string searchPatternMeta = guid + "\n";
+			if (!blockedPrefab)
+				continue;
 			
-			array<string> pieces = {};
-			fileContent.Split(searchPattern, pieces, false);
+			string guid = blockedPrefab.m_sGuid;
+			guid.TrimInPlace();
+			guid.ToUpper();
 			
-			if (pieces.Count() > 1)
+			if (!IsValidGuid(guid))
 			{
-				//Print(string.Format("Loadout Cleaner: Found and removed GUID '%1' in file %2", guid, filePath), LogLevel.NORMAL);
-				fileContent = SCR_StringHelper.Join(replacePatternCore, pieces);
+				Print(string.Format("Loadout Cleaner WARNING: Ignoring malformed blocklist GUID '%1' (%2).", blockedPrefab.m_sGuid, blockedPrefab.m_sName), LogLevel.WARNING);
+				continue;
 			}
 			
-			if (fileContent.Contains(searchPatternMeta))
+			if (blockedGuids.Contains(guid))
 			{
-				fileContent.Replace(searchPatternMeta, "");
+				Print(string.Format("Loadout Cleaner WARNING: Ignoring duplicate blocklist GUID '%1' (%2).", guid, blockedPrefab.m_sName), LogLevel.WARNING);
+				continue;
 			}
+			
+			blockedGuids.Insert(guid);
 		}
-
-		if (fileContent != originalFileContent)
+		
+		Print(string.Format("Loadout Cleaner: Blocklist compiled with %1 prefab GUIDs.", blockedGuids.Count()), LogLevel.NORMAL);
+		return blockedGuids;
+	}
+	
+	// --- Returns true if the string is exactly 16 upper-case hex characters ---
+	private static bool IsValidGuid(string guid)
+	{
+		if (guid.Length() != GUID_LENGTH)
+			return false;
+		
+		for (int i = 0; i < GUID_LENGTH; i++)
+		{
+			if (!HEX_DIGITS.Contains(guid.Get(i)))
+				return false;
+		}
+		
+		return true;
+	}
+	
+	// --- Walks the entity hierarchy and collects blocked items. Children of a blocked item go with it ---
+	private static void CollectBlockedItems(IEntity parent, set<string> blockedGuids, array<IEntity> blockedItems)
+	{
+		IEntity child = parent.GetChildren();
+		while (child)
 		{
-			//Print(string.Format("Loadout Cleaner: Modification found for %1. Saving file.", filePath), LogLevel.NORMAL);
+			if (blockedGuids.Contains(GetPrefabGuid(child)))
+				blockedItems.Insert(child);
+			else
+				CollectBlockedItems(child, blockedGuids, blockedItems);
 			
-			array<string> contentToWrite = { fileContent };
+			child = child.GetSibling();
+		}
+	}
+	
+	// --- Returns the GUID of the entity's prefab ("{GUID}path.et"), or an empty string ---
+	private static string GetPrefabGuid(IEntity entity)
+	{
+		EntityPrefabData prefabData = entity.GetPrefabData();
+		if (!prefabData)
+			return string.Empty;
+		
+		ResourceName prefab = prefabData.GetPrefabName();
+		if (prefab.Length() < GUID_LENGTH + 2 || prefab.Get(0) != "{")
+			return string.Empty;
+		
+		return prefab.Substring(1, GUID_LENGTH);
+	}
+	
+	// --- Adds a single entry to a blocklist ---
+	private static void AddBlockedPrefab(array<ref NarcoBlockedPrefab> blockedPrefabs, string guid, string name)
+	{
+		NarcoBlockedPrefab blockedPrefab = new NarcoBlockedPrefab();
+		blockedPrefab.m_sGuid = guid;
+		blockedPrefab.m_sName = name;
+		blockedPrefabs.Insert(blockedPrefab);
+	}
+
+	// --- Processes a single player loadout file ---
+	// Streams the file in fixed-size chunks into a temp file, so memory use doesn't depend on the file size.
+	// The temp file only replaces the original if something was removed. Returns false if the file couldn't be
+	// processed; contentHash is the hash of the resulting content.
+	private static bool ProcessLoadoutFile(string filePath, set<string> blockedGuids, out int contentHash, out bool modified)
+	{
+		FileHandle input = FileIO.OpenFile(filePath, FileMode.READ);
+		if (!input)
+			return false;
+		
+		string tempPath = filePath + TEMP_SUFFIX;
+		s_StreamOutput = FileIO.OpenFile(tempPath, FileMode.WRITE);
+		if (!s_StreamOutput)
+		{
+			input.Close();
+			Print(string.Format("Loadout Cleaner ERROR: Failed to open temp file for: %1", filePath), LogLevel.ERROR);
+			return false;
+		}
+		
+		s_sPendingOutput = string.Empty;
+		s_iOutputHash = 0;
+		s_bStreamModified = false;
+		
+		string carry;
+		string chunk;
+		bool endOfFile;
+		while (!endOfFile)
+		{
+			chunk = string.Empty;
+			endOfFile = input.Read(chunk, CHUNK_SIZE) < CHUNK_SIZE;
 			
-			if (!SCR_FileIOHelper.WriteFileContent(filePath, contentToWrite))
+			string buffer = carry + chunk;
+			int consumed = FilterBuffer(buffer, endOfFile, blockedGuids);
+			carry = buffer.Substring(consumed, buffer.Length() - consumed);
+		}
+		
+		input.Close();
+		FlushOutput(true);
+		s_StreamOutput.Close();
+		s_StreamOutput = null;
+		
+		modified = s_bStreamModified;
+		contentHash = s_iOutputHash;
+		
+		if (modified && !FileIO.CopyFile(tempPath, filePath))
+		{
+			Print(string.Format("Loadout Cleaner ERROR: Failed to save modified file: %1", filePath), LogLevel.ERROR);
+			return false;
+		}
+		
+		//if (modified)
+		//	Print(string.Format("Loadout Cleaner: Modification found for %1. Saved file.", filePath), LogLevel.NORMAL);
+		
+		FileIO.DeleteFile(tempPath);
+		return true;
+	}
+	
+	// --- Filters one buffer (carried text plus the new chunk) and emits the result ---
+	// Every escaped prefab reference and every line end is checked against the blocklist: blocked prefab references
+	// are emptied, blocked GUIDs ending a line are removed together with the line break. Only matches starting
+	// before the overlap are handled, unless this is the end of the file. Returns how much of the buffer was consumed.
+	private static int FilterBuffer(string buffer, bool endOfFile, set<string> blockedGuids)
+	{
+		string escapedQuote = SCR_StringHelper.ANTISLASH + SCR_StringHelper.DOUBLE_QUOTE;
+		string prefabToken = escapedQuote + "prefab" + escapedQuote + ":" + escapedQuote;
+		string replacePatternCore = prefabToken + escapedQuote;
+		int bufferLength = buffer.Length();
+		
+		int scanLimit = bufferLength;
+		if (!endOfFile)
+			scanLimit = bufferLength - CHUNK_OVERLAP;
+		
+		if (scanLimit <= 0)
+			return 0;
+		
+		int copiedUpTo = 0;
+		int nextPrefab = buffer.IndexOf(prefabToken);
+		int nextLineEnd = buffer.IndexOf("\n");
+		
+		while ((nextPrefab >= 0 && nextPrefab < scanLimit) || (nextLineEnd >= 0 && nextLineEnd - GUID_LENGTH - 1 < scanLimit))
+		{
+			if (nextPrefab >= 0 && nextPrefab < scanLimit && (nextLineEnd < 0 || nextPrefab < nextLineEnd))
 			{
-				Print(string.Format("Loadout Cleaner ERROR: Failed to save modified file: %1", filePath), LogLevel.ERROR);
+				int guidStart = nextPrefab + prefabToken.Length();
+				int guidEnd = guidStart + GUID_LENGTH;
+				
+				if (guidEnd + escapedQuote.Length() <= bufferLength
+					&& buffer.Substring(guidEnd, escapedQuote.Length()) == escapedQuote
+					&& blockedGuids.Contains(buffer.Substring(guidStart, GUID_LENGTH)))
+				{
+					EmitOutput(buffer.Substring(copiedUpTo, nextPrefab - copiedUpTo));
+					EmitOutput(replacePatternCore);
+					copiedUpTo = guidEnd + escapedQuote.Length();
+					s_bStreamModified = true;
+				}
+				
+				nextPrefab = buffer.IndexOfFrom(guidStart, prefabToken);
+				if (nextLineEnd >= 0 && nextLineEnd < copiedUpTo)
+					nextLineEnd = buffer.IndexOfFrom(copiedUpTo, "\n");
 			}
+			else
+			{
+				// Files with Windows line ends carry a carriage return between the GUID and the line break.
+				int lineGuidEnd = nextLineEnd;
+				if (lineGuidEnd > 0 && buffer.Get(lineGuidEnd - 1) == "\r")
+					lineGuidEnd--;
+				
+				int lineGuidStart = lineGuidEnd - GUID_LENGTH;
+				if (lineGuidStart >= copiedUpTo && blockedGuids.Contains(buffer.Substring(lineGuidStart, GUID_LENGTH)))
+				{
+					EmitOutput(buffer.Substring(copiedUpTo, lineGuidStart - copiedUpTo));
+					copiedUpTo = nextLineEnd + 1;
+					s_bStreamModified = true;
+				}
+				
+				nextLineEnd = buffer.IndexOfFrom(nextLineEnd + 1, "\n");
+			}
+		}
+		
+		int consumed = Math.Max(scanLimit, copiedUpTo);
+		EmitOutput(buffer.Substring(copiedUpTo, consumed - copiedUpTo));
+		return consumed;
+	}
+	
+	// --- Queues filtered text for the temp file ---
+	private static void EmitOutput(string text)
+	{
+		s_sPendingOutput += text;
+		FlushOutput(false);
+	}
+	
+	// --- Writes queued text in CHUNK_SIZE pieces, so the output hash matches a chunked read of the written file ---
+	private static void FlushOutput(bool endOfFile)
+	{
+		while (s_sPendingOutput.Length() >= CHUNK_SIZE || (endOfFile && !s_sPendingOutput.IsEmpty()))
+		{
+			int pieceLength = Math.Min(CHUNK_SIZE, s_sPendingOutput.Length());
+			string piece = s_sPendingOutput.Substring(0, pieceLength);
+			s_StreamOutput.FPrint(piece);
+			s_iOutputHash = s_iOutputHash * 31 + piece.Hash();
+			s_sPendingOutput = s_sPendingOutput.Substring(pieceLength, s_sPendingOutput.Length() - pieceLength);
 		}
 	}
 }
+
+
+// --- Priority cleaning for connecting players and on-spawn sanitization ---
+modded class SCR_BaseGameMode
+{
+	//------------------------------------------------------------------------------------------------
+	override void OnPlayerSpawnFinalize_S(SCR_SpawnRequestComponent requestComponent, SCR_SpawnHandlerComponent handlerComponent, SCR_SpawnData data, IEntity entity)
+	{
+		super.OnPlayerSpawnFinalize_S(requestComponent, handlerComponent, data, entity);
+		
+		if (!IsMaster() || !NarcoJsonSettingsManager.GetInstance().GetLoadoutCleanerSettings().m_bSanitizeOnSpawn)
+			return;
+		
+		// Only saved loadouts are filtered. Default role kits carry blocked items (AT and AA launchers) on purpose.
+		if (!IsSavedLoadoutSpawn(requestComponent))
+			return;
+		
+		int removedItems = LoadoutCleaner.SanitizeSpawnedEntity(entity);
+		if (removedItems > 0)
+			Print(string.Format("Loadout Cleaner: Removed %1 blocked items from %2 on spawn.", removedItems, GetGame().GetPlayerManager().GetPlayerName(requestComponent.GetPlayerId())), LogLevel.NORMAL);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Returns true if the player spawned with a saved loadout rather than a faction role loadout.
+	//! Role loadouts are the only kind excluded, so loadouts the loadout editor mods bring in their own classes count as saved.
+	protected bool IsSavedLoadoutSpawn(SCR_SpawnRequestComponent requestComponent)
+	{
+		PlayerController playerController = requestComponent.GetPlayerController();
+		if (!playerController)
+			return false;
+		
+		SCR_PlayerLoadoutComponent loadoutComponent = SCR_PlayerLoadoutComponent.Cast(playerController.FindComponent(SCR_PlayerLoadoutComponent));
+		if (!loadoutComponent)
+			return false;
+		
+		SCR_BasePlayerLoadout loadout = loadoutComponent.GetLoadout();
+		return loadout && !SCR_FactionPlayerLoadout.Cast(loadout);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	override void OnPlayerAuditSuccess(int iPlayerID)
+	{
+		super.OnPlayerAuditSuccess(iPlayerID);
+		
+		if (IsMaster() && LoadoutCleaner.IsRunning())
+			LoadoutCleaner.CleanPlayerFiles(GetGame().GetBackendApi().GetPlayerIdentityId(iPlayerID));
+	}
+}
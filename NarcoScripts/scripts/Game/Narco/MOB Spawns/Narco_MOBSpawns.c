@@ -13,9 +13,8 @@ modded class SCR_CampaignSpawnPointGroup : SCR_SpawnPoint
     override bool IsSpawnPointEnabled()
     {
 		// First, check if this feature is enabled in the unified config file.
-		// If the settings manager hasn't loaded or the feature is disabled, fall back to default game behavior.
-		NarcoJsonSettingsManager settingsManager = NarcoJsonSettingsManager.GetInstance();
-		if (!settingsManager || !settingsManager.GetMOBSpawnsSettings() || !settingsManager.GetMOBSpawnsSettings().m_bEnabled)
+		// If the feature is disabled, fall back to default game behavior.
+		if (!NarcoSettingsSnapshot.Get().m_bMOBSpawnsEnabled)
 			return super.IsSpawnPointEnabled();
 		
         // Get the parent entity of this spawn point, which is the base itself.
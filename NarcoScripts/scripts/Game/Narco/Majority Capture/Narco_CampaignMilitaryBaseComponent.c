@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------------------------
+// SCRIPT: Narco_CampaignMilitaryBaseComponent.c
+// PURPOSE: Caches the base-dependent inputs of the Majority Capture seizing timer.
+//------------------------------------------------------------------------------------------------
+
+modded class SCR_CampaignMilitaryBaseComponent
+{
+	// Each built service of these types extends the seizing time.
+	protected static ref array<SCR_EServicePointType> s_aSeizingServiceTypes = { SCR_EServicePointType.ARMORY, SCR_EServicePointType.HELIPAD, SCR_EServicePointType.BARRACKS, SCR_EServicePointType.RADIO_ANTENNA, SCR_EServicePointType.FIELD_HOSPITAL, SCR_EServicePointType.LIGHT_VEHICLE_DEPOT, SCR_EServicePointType.HEAVY_VEHICLE_DEPOT };
+	
+	// Radio coverage depends on the bases in range, not just this one. A change on any base bumps the revision,
+	// which stales the radio count of every base.
+	protected static int s_iRadioNetworkRevision;
+	
+	protected int m_iSeizingServicesCount = -1;
+	protected int m_iSeizingRadioConnectionsCount;
+	protected int m_iSeizingRadioNetworkRevision = -1;
+	
+	//------------------------------------------------------------------------------------------------
+	override void OnPostInit(IEntity owner)
+	{
+		super.OnPostInit(owner);
+		
+		// Relays and HQs change coverage without touching this base. Subscribed once, not once per base.
+		SCR_GameModeCampaign campaign = SCR_GameModeCampaign.GetInstance();
+		if (campaign)
+		{
+			campaign.GetOnSignalChanged().Remove(OnRadioNetworkChanged);
+			campaign.GetOnSignalChanged().Insert(OnRadioNetworkChanged);
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	override void OnFactionChanged(FactionAffiliationComponent owner, Faction previousFaction, Faction faction)
+	{
+		super.OnFactionChanged(owner, previousFaction, faction);
+		InvalidateSeizingInputs();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	override void RegisterLogicComponent(notnull SCR_MilitaryBaseLogicComponent component)
+	{
+		super.RegisterLogicComponent(component);
+		InvalidateSeizingInputs();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	override void UnregisterLogicComponent(notnull SCR_MilitaryBaseLogicComponent component)
+	{
+		super.UnregisterLogicComponent(component);
+		InvalidateSeizingInputs();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Drops the cached service count of this base and the radio counts of all bases. They are rebuilt on next use.
+	protected void InvalidateSeizingInputs()
+	{
+		m_iSeizingServicesCount = -1;
+		s_iRadioNetworkRevision++;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Drops the cached radio counts of all bases.
+	protected static void OnRadioNetworkChanged(SCR_CampaignMilitaryBaseComponent base)
+	{
+		s_iRadioNetworkRevision++;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Returns the number of built services that extend the seizing time.
+	int GetSeizingServicesCount()
+	{
+		if (m_iSeizingServicesCount >= 0)
+			return m_iSeizingServicesCount;
+		
+		m_iSeizingServicesCount = 0;
+		foreach (SCR_EServicePointType type : s_aSeizingServiceTypes)
+		{
+			if (GetServiceDelegateByType(type))
+				m_iSeizingServicesCount++;
+		}
+		
+		return m_iSeizingServicesCount;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Returns the number of friendly radios in range of this base.
+	int GetSeizingRadioConnectionsCount()
+	{
+		if (m_iSeizingRadioNetworkRevision == s_iRadioNetworkRevision)
+			return m_iSeizingRadioConnectionsCount;
+		
+		m_iSeizingRadioNetworkRevision = s_iRadioNetworkRevision;
+		m_iSeizingRadioConnectionsCount = 0;
+		
+		SCR_CoverageRadioComponent radio = SCR_CoverageRadioComponent.Cast(GetOwner().FindComponent(SCR_CoverageRadioComponent));
+		SCR_CampaignFaction faction = GetCampaignFaction();
+		if (radio && faction && faction.IsPlayable())
+			m_iSeizingRadioConnectionsCount = radio.GetRadiosInRangeOfCount(faction.GetFactionRadioEncryptionKey());
+		
+		return m_iSeizingRadioConnectionsCount;
+	}
+}
@@ -15,6 +15,17 @@ modded class SCR_CampaignSeizingComponent : SCR_SeizingComponent
 	protected bool m_bMajorityCaptureEnabled;
 	protected int m_iRequiredSeizingMajority_Config;
 	protected float m_fMajorityDebounceTime_Config;
+	protected bool m_bIdleBackoffDisabled_Config;
+	protected float m_fIdleQueryInterval_Config;
+	protected float m_fWakeRadius_Config;
+	protected float m_fWakeCheckInterval_Config;
+	protected float m_fReplicationWindow_Config;
+	
+	// --- CONSTANTS ---
+	protected static const float DEFAULT_IDLE_QUERY_INTERVAL = 5;
+	protected static const float DEFAULT_WAKE_RADIUS = 250;
+	protected static const float DEFAULT_WAKE_CHECK_INTERVAL = 1;
+	protected static const float DEFAULT_REPLICATION_WINDOW = 0.5;
 	
 	// --- Original Member Variables ---
 	protected float m_fExtraTimePerService;
@@ -24,6 +35,29 @@ modded class SCR_CampaignSeizingComponent : SCR_SeizingComponent
 	protected Faction m_pMajorityCandidateFaction; 
 	protected WorldTimestamp m_fLastTickTimestamp; 
 	protected string m_sLogPrefix;
+	protected int m_iLogBaseIndex;
+	
+	// --- Query buffers (reused across queries to avoid per-query allocations) ---
+	// Counts are indexed by faction index; only the touched entries are reset after each tally.
+	protected ref array<IEntity> m_aPresentEntities = {};
+	protected ref array<int> m_aFactionPresence = {};
+	protected ref array<int> m_aPresentFactionIndices = {};
+	protected FactionManager m_FactionManager;
+	
+	// --- Idle backoff ---
+	// While idle the trigger queries at the idle interval and a cheap sphere check watches the wake radius instead.
+	protected bool m_bQueryIdle;
+	protected float m_fActiveQueryRate;
+	protected bool m_bWakeCheckFoundCharacter;
+	protected WorldTimestamp m_fNextIdleCheckTimestamp;
+	
+	// --- Replication coalescing ---
+	// The first change in a window is sent right away, later ones only once when the window closes.
+	// Capture start and interrupt RPCs are derived from the last sent state, so a blip inside a window sends nothing.
+	protected bool m_bReplicationWindowOpen;
+	protected bool m_bReplicationPending;
+	protected bool m_bSentCaptureRunning;
+	protected int m_iSentCaptureFactionIndex = -1;
 
 	//------------------------------------------------------------------------------------------------
 	//! Called after the component has been initialized by the engine.
@@ -31,21 +65,15 @@ modded class SCR_CampaignSeizingComponent : SCR_SeizingComponent
 	{
 		super.OnPostInit(owner);
 		
-		// Load settings from the unified config file.
-		NarcoMajorityCaptureSettings settings = NarcoJsonSettingsManager.GetInstance().GetMajorityCaptureSettings();
-		m_bMajorityCaptureEnabled = settings.m_bEnabled;
-		m_iRequiredSeizingMajority_Config = settings.m_iRequiredSeizingMajority;
-		m_fMajorityDebounceTime_Config = settings.m_fMajorityDebounceTime; 
-		
-		if (!m_bMajorityCaptureEnabled)
-		{
-			Print("Majority Capture Mod is disabled in config.", LogLevel.NORMAL);
-			return;
-		}
-		
+		// Only the server reads the config, see EOnFrame() for what clients do instead.
 		if (m_RplComponent && m_RplComponent.IsMaster())
 		{
+			ApplyMajorityCaptureSettings();
+			if (!m_bMajorityCaptureEnabled)
+				Print("Majority Capture Mod is disabled in config.", LogLevel.NORMAL);
+			
 			m_sLogPrefix = string.Format("[CSB:%1]", owner.GetName());
+			m_iLogBaseIndex = NarcoCaptureEventLog.RegisterBase(owner.GetName());
 			
 			m_fMajorityHeldDuration = 0.0;
 			m_pMajorityCandidateFaction = null;
@@ -54,15 +82,81 @@ modded class SCR_CampaignSeizingComponent : SCR_SeizingComponent
 			if (world)
 				m_fLastTickTimestamp = world.GetServerTimestamp();
 			
-			Print(string.Format("Majority Capture Mod: %1 Initialized on Server.", m_sLogPrefix), LogLevel.NORMAL);
+			// Stays subscribed while disabled, so the mod can be switched on by a config reload.
+			NarcoSettingsSnapshot.GetOnPublished().Insert(OnSettingsPublished);
+			
+			if (m_bMajorityCaptureEnabled)
+				Print(string.Format("Majority Capture Mod: %1 Initialized on Server.", m_sLogPrefix), LogLevel.NORMAL);
 		}
 	}
 	
+	//------------------------------------------------------------------------------------------------
+	override void OnDelete(IEntity owner)
+	{
+		GetGame().GetCallqueue().Remove(CheckWakeRadius);
+		GetGame().GetCallqueue().Remove(CloseReplicationWindow);
+		NarcoSettingsSnapshot.GetOnPublished().Remove(OnSettingsPublished);
+		super.OnDelete(owner);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Reads the majority capture section of the unified config file.
+	protected void ApplyMajorityCaptureSettings()
+	{
+		NarcoMajorityCaptureSettings settings = NarcoJsonSettingsManager.GetInstance().GetMajorityCaptureSettings();
+		m_bMajorityCaptureEnabled = settings.m_bEnabled;
+		m_iRequiredSeizingMajority_Config = settings.m_iRequiredSeizingMajority;
+		m_fMajorityDebounceTime_Config = settings.m_fMajorityDebounceTime;
+		m_bIdleBackoffDisabled_Config = settings.m_bDisableIdleBackoff;
+		m_fIdleQueryInterval_Config = settings.m_fIdleQueryInterval;
+		m_fWakeRadius_Config = settings.m_fWakeRadius;
+		m_fWakeCheckInterval_Config = settings.m_fWakeCheckInterval;
+		
+		// Older config files do not have the idle backoff fields yet.
+		if (m_fIdleQueryInterval_Config <= 0)
+			m_fIdleQueryInterval_Config = DEFAULT_IDLE_QUERY_INTERVAL;
+		
+		if (m_fWakeRadius_Config <= 0)
+			m_fWakeRadius_Config = DEFAULT_WAKE_RADIUS;
+		
+		if (m_fWakeCheckInterval_Config <= 0)
+			m_fWakeCheckInterval_Config = DEFAULT_WAKE_CHECK_INTERVAL;
+		
+		m_fReplicationWindow_Config = settings.m_fReplicationWindow;
+		if (m_fReplicationWindow_Config <= 0)
+			m_fReplicationWindow_Config = DEFAULT_REPLICATION_WINDOW;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Called after the config file was reloaded. A pending majority is dropped when the mod is switched on or off.
+	protected void OnSettingsPublished(NarcoSettingsSnapshot snapshot)
+	{
+		bool wasEnabled = m_bMajorityCaptureEnabled;
+		ApplyMajorityCaptureSettings();
+		
+		// The next query without anyone present goes idle again with the new values.
+		if (m_bQueryIdle)
+			ExitIdleQueryRate();
+		
+		if (m_bMajorityCaptureEnabled == wasEnabled)
+			return;
+		
+		m_fMajorityHeldDuration = 0.0;
+		m_pMajorityCandidateFaction = null;
+		
+		if (m_bMajorityCaptureEnabled)
+			Print(string.Format("Majority Capture Mod: %1 Enabled by config reload.", m_sLogPrefix), LogLevel.NORMAL);
+		else
+			Print(string.Format("Majority Capture Mod: %1 Disabled by config reload.", m_sLogPrefix), LogLevel.NORMAL);
+	}
+	
 	//------------------------------------------------------------------------------------------------
 	//! Called every frame to control the capture timer.
 	override void EOnFrame(IEntity owner, float timeSlice)
 	{
-		if (!m_bMajorityCaptureEnabled)
+		// Only a server running the mod ever pauses the timer, so proxies always honour a pause.
+		bool honourPause = m_bMajorityCaptureEnabled || (m_RplComponent && m_RplComponent.IsProxy());
+		if (!honourPause)
 		{
 			super.EOnFrame(owner, timeSlice);
 			return;
@@ -87,81 +181,121 @@ modded class SCR_CampaignSeizingComponent : SCR_SeizingComponent
 		
 		m_bQueryFinished = true;
 
-		array<IEntity> presentEntities = {};
-		int presentEntitiesCnt = m_Trigger.GetEntitiesInside(presentEntities);
+		m_aPresentEntities.Clear();
+		int presentEntitiesCnt = m_Trigger.GetEntitiesInside(m_aPresentEntities);
 		m_bCharacterPresent = presentEntitiesCnt != 0;
+		
+		if (!m_FactionManager)
+		{
+			m_FactionManager = GetGame().GetFactionManager();
+			m_aFactionPresence.Resize(m_FactionManager.GetFactionsCount());
+		}
 
-		map<SCR_Faction, int> factionsPresence = new map<SCR_Faction, int>();
 		for (int i = 0; i < presentEntitiesCnt; i++)
 		{
-			IEntity entity = presentEntities[i];
+			IEntity entity = m_aPresentEntities[i];
 			if (m_bDeleteDisabledAIs && IsDisabledAI(entity))
 			{
 				RplComponent.DeleteRplEntity(entity, false);	
 				continue;
 			}				
 			
-			SCR_Faction evaluatedEntityFaction = EvaluateEntityFaction(presentEntities[i]);
+			SCR_Faction evaluatedEntityFaction = EvaluateEntityFaction(entity);
 			if (!evaluatedEntityFaction)
 				continue;
 
-			int factionCnt = factionsPresence.Get(evaluatedEntityFaction);
-			factionsPresence.Set(evaluatedEntityFaction, factionCnt + 1);
+			int entityFactionIndex = m_FactionManager.GetFactionIndex(evaluatedEntityFaction);
+			if (entityFactionIndex < 0)
+				continue;
+			
+			if (entityFactionIndex >= m_aFactionPresence.Count())
+				m_aFactionPresence.Resize(entityFactionIndex + 1);
+			
+			if (m_aFactionPresence[entityFactionIndex] == 0)
+				m_aPresentFactionIndices.Insert(entityFactionIndex);
+			
+			m_aFactionPresence[entityFactionIndex] = m_aFactionPresence[entityFactionIndex] + 1;
 		}
 		m_bDeleteDisabledAIs = false;
+		m_aPresentEntities.Clear();
 		
-		SCR_Faction newPrevailingFactionCandidate = null;
+		// One pass over the present factions. The attacker is the single strongest eligible faction (a tie means none).
+		// The two strongest defenders are kept, so the strongest one other than the attacker is known without a second pass.
+		int attackerIndex = -1;
 		int newHighestAttackingPresence = 0;
-		int newHighestDefendingPresence = 0;
-		int newSeizingCharactersNet = 0;
+		int topDefenderIndex = -1;
+		int topDefendingPresence = 0;
+		int secondDefendingPresence = 0;
 
-		for (int i = 0, cnt = factionsPresence.Count(); i < cnt; i++)
+		foreach (int presentFactionIndex : m_aPresentFactionIndices)
 		{
-			if (m_bIgnoreNonPlayableAttackers && !factionsPresence.GetKey(i).IsPlayable()) continue;
-			int currentPresence = factionsPresence.GetElement(i);
-			if (currentPresence > newHighestAttackingPresence)
+			int currentPresence = m_aFactionPresence[presentFactionIndex];
+			m_aFactionPresence[presentFactionIndex] = 0;
+			
+			bool isPlayable = SCR_Faction.Cast(m_FactionManager.GetFactionByIndex(presentFactionIndex)).IsPlayable();
+			
+			if (isPlayable || !m_bIgnoreNonPlayableAttackers)
 			{
-				newHighestAttackingPresence = currentPresence;
-				newPrevailingFactionCandidate = factionsPresence.GetKey(i);
+				if (currentPresence > newHighestAttackingPresence)
+				{
+					newHighestAttackingPresence = currentPresence;
+					attackerIndex = presentFactionIndex;
+				}
+				else if (currentPresence == newHighestAttackingPresence)
+				{
+					attackerIndex = -1;
+				}
 			}
-			else if (currentPresence == newHighestAttackingPresence)	
+			
+			if (isPlayable || !m_bIgnoreNonPlayableDefenders)
 			{
-				newPrevailingFactionCandidate = null;
+				if (currentPresence > topDefendingPresence)
+				{
+					secondDefendingPresence = topDefendingPresence;
+					topDefendingPresence = currentPresence;
+					topDefenderIndex = presentFactionIndex;
+				}
+				else if (currentPresence > secondDefendingPresence)
+				{
+					secondDefendingPresence = currentPresence;
+				}
 			}
 		}
-
-		if (newPrevailingFactionCandidate) 
+		m_aPresentFactionIndices.Clear();
+		
+		SCR_Faction newPrevailingFactionCandidate = null;
+		int newSeizingCharactersNet = 0;
+		
+		if (attackerIndex >= 0) 
 		{
-			for (int i = 0, cnt = factionsPresence.Count(); i < cnt; i++)
-			{
-				if (m_bIgnoreNonPlayableDefenders && !factionsPresence.GetKey(i).IsPlayable()) continue;
-				if (factionsPresence.GetKey(i) == newPrevailingFactionCandidate) continue;
-				newHighestDefendingPresence = Math.Max(factionsPresence.GetElement(i), newHighestDefendingPresence);
-			}
+			int newHighestDefendingPresence = topDefendingPresence;
+			if (topDefenderIndex == attackerIndex)
+				newHighestDefendingPresence = secondDefendingPresence;
 
 			if (newHighestAttackingPresence > newHighestDefendingPresence)
+			{
+				newPrevailingFactionCandidate = SCR_Faction.Cast(m_FactionManager.GetFactionByIndex(attackerIndex));
 				newSeizingCharactersNet = Math.Min(newHighestAttackingPresence - newHighestDefendingPresence, m_iMaximumSeizingCharacters);
-			else 
-				newPrevailingFactionCandidate = null;
+			}
 		}
 		
 		bool stateChanged = (m_PrevailingFaction != newPrevailingFactionCandidate || m_iSeizingCharacters != newSeizingCharactersNet);
 		
 		if (stateChanged && m_sLogPrefix)
-		{
-			string oldFactionKey = "null";
-			if (m_PrevailingFaction)
-				oldFactionKey = m_PrevailingFaction.GetFactionKey();
-			
-			string newFactionKey = "null";
-			if (newPrevailingFactionCandidate)
-				newFactionKey = newPrevailingFactionCandidate.GetFactionKey();
-
-			Print(string.Format("Majority Capture Mod: %1 StateChanged - Faction: %2 -> %3, Seizers: %4 -> %5", m_sLogPrefix, oldFactionKey, newFactionKey, m_iSeizingCharacters, newSeizingCharactersNet), LogLevel.NORMAL);
-		}
+			NarcoCaptureEventLog.RecordStateChanged(m_iLogBaseIndex, m_PrevailingFaction, m_iSeizingCharacters, newPrevailingFactionCandidate, newSeizingCharactersNet);
 		
 		m_PrevailingFaction = newPrevailingFactionCandidate;
 		m_iSeizingCharacters = newSeizingCharactersNet;
+		
+		if (m_bCharacterPresent)
+		{
+			if (m_bQueryIdle)
+				ExitIdleQueryRate(false);
+		}
+		else if (!m_bQueryIdle && !m_bIdleBackoffDisabled_Config && !m_PrevailingFaction)
+		{
+			TryEnterIdleQueryRate();
+		}
 
 		bool isTimerRunning = m_fSeizingStartTimestamp != 0;
 		
@@ -197,17 +331,89 @@ modded class SCR_CampaignSeizingComponent : SCR_SeizingComponent
 
 			if (m_pMajorityCandidateFaction && m_fMajorityHeldDuration >= m_fMajorityDebounceTime_Config)
 			{
-				Print(string.Format("Majority Capture Mod: %1 Majority held (%.2fs), starting capture for %2.", m_sLogPrefix, m_fMajorityHeldDuration, m_PrevailingFaction.GetFactionKey()), LogLevel.NORMAL);
+				NarcoCaptureEventLog.RecordCaptureStarted(m_iLogBaseIndex, m_PrevailingFaction, m_iSeizingCharacters, m_fMajorityHeldDuration);
 				m_fSeizingStartTimestamp = world.GetServerTimestamp();
-				RefreshSeizingTimer();
 				
-				int factionIndex = GetGame().GetFactionManager().GetFactionIndex(m_PrevailingFaction);
-				Rpc(RpcDo_OnCaptureStart, factionIndex);
-				RpcDo_OnCaptureStart(factionIndex);
+				// A new capture, the previous one may have ended without passing through here.
+				m_bSentCaptureRunning = false;
+				RefreshSeizingTimer();
 			}
 		}
 	}
 
+	//------------------------------------------------------------------------------------------------
+	//! Goes idle once nobody is within the wake radius either. Without this, a character between the trigger and the
+	//! wake radius would flip the point between idle and active on every wake check. Checks at most once per wake check interval.
+	protected void TryEnterIdleQueryRate()
+	{
+		ChimeraWorld world = GetOwner().GetWorld();
+		if (!world)
+			return;
+		
+		WorldTimestamp now = world.GetServerTimestamp();
+		if (m_fNextIdleCheckTimestamp != 0 && m_fNextIdleCheckTimestamp.DiffSeconds(now) > 0)
+			return;
+		
+		m_fNextIdleCheckTimestamp = now.PlusMilliseconds(m_fWakeCheckInterval_Config * 1000);
+		if (!IsCharacterInWakeRadius())
+			EnterIdleQueryRate();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Slows the trigger down to the idle interval and starts watching the wake radius.
+	protected void EnterIdleQueryRate()
+	{
+		m_bQueryIdle = true;
+		// The update rate is the time in seconds between queries.
+		m_fActiveQueryRate = m_Trigger.GetUpdateRate();
+		m_Trigger.SetUpdateRate(Math.Max(m_fIdleQueryInterval_Config, m_fActiveQueryRate));
+		GetGame().GetCallqueue().CallLater(CheckWakeRadius, m_fWakeCheckInterval_Config * 1000, true);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Restores the full trigger query rate. Queries right away unless called with fresh query results.
+	protected void ExitIdleQueryRate(bool queryNow = true)
+	{
+		m_bQueryIdle = false;
+		GetGame().GetCallqueue().Remove(CheckWakeRadius);
+		m_Trigger.SetUpdateRate(m_fActiveQueryRate);
+		
+		if (queryNow)
+			m_Trigger.QueryEntitiesInside();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Called from the call queue while idle. Wakes the capture point as soon as any character is within the wake radius.
+	protected void CheckWakeRadius()
+	{
+		if (IsCharacterInWakeRadius())
+			ExitIdleQueryRate();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	protected bool IsCharacterInWakeRadius()
+	{
+		BaseWorld world = GetOwner().GetWorld();
+		if (!world)
+			return false;
+		
+		m_bWakeCheckFoundCharacter = false;
+		float radius = Math.Max(m_fWakeRadius_Config, m_Trigger.GetSphereRadius());
+		world.QueryEntitiesBySphere(m_Trigger.GetOrigin(), radius, OnWakeCheckEntity, null, EQueryEntitiesFlags.DYNAMIC);
+		return m_bWakeCheckFoundCharacter;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Stops the sphere query at the first character found.
+	protected bool OnWakeCheckEntity(IEntity entity)
+	{
+		if (!ChimeraCharacter.Cast(entity))
+			return true;
+		
+		m_bWakeCheckFoundCharacter = true;
+		return false;
+	}
+	
 	//------------------------------------------------------------------------------------------------
 	//! Recalculates and adjusts the capture timer based on current conditions.
 	override void RefreshSeizingTimer()
@@ -229,58 +435,40 @@ modded class SCR_CampaignSeizingComponent : SCR_SeizingComponent
 		{
 			if (!wasPaused)
 			{
-				string reason = "majority lost";
+				NarcoECaptureInterruptReason reason = NarcoECaptureInterruptReason.MAJORITY_LOST;
 				if (m_PrevailingFaction == m_FactionControl.GetAffiliatedFaction())
-					reason = "defenders regained control";
+					reason = NarcoECaptureInterruptReason.DEFENDERS_REGAINED_CONTROL;
 				else if (!m_PrevailingFaction)
-					reason = "no prevailing faction";
+					reason = NarcoECaptureInterruptReason.NO_PREVAILING_FACTION;
 				
-				Print(string.Format("Majority Capture Mod: %1 Capture interrupted. Reason: %2.", m_sLogPrefix, reason), LogLevel.NORMAL);
+				NarcoCaptureEventLog.RecordCaptureInterrupted(m_iLogBaseIndex, m_PrevailingFaction, m_iSeizingCharacters, reason);
 				
 				m_fInterruptedCaptureTimestamp = world.GetServerTimestamp();
 				m_fInterruptedCaptureDuration = m_fInterruptedCaptureTimestamp.DiffMilliseconds(m_fSeizingStartTimestamp);
-
-				if (m_PrevailingFaction)
-				{
-					int factionIndex = GetGame().GetFactionManager().GetFactionIndex(m_PrevailingFaction);
-					Rpc(RpcDo_OnCaptureInterrupt, factionIndex);
-					RpcDo_OnCaptureInterrupt(factionIndex);
-				}
 			}
 			
 			m_fSeizingEndTimestamp = m_fSeizingStartTimestamp;
-			Replication.BumpMe();
-			OnSeizingTimestampChanged();
+			RequestSeizingUpdate();
 			return;
 		}
 
 		if (wasPaused)
 		{
-			Print(string.Format("Majority Capture Mod: %1 Capture resumed for %2.", m_sLogPrefix, m_PrevailingFaction.GetFactionKey()), LogLevel.NORMAL);
+			NarcoCaptureEventLog.RecordCaptureResumed(m_iLogBaseIndex, m_PrevailingFaction, m_iSeizingCharacters);
 			if (m_fInterruptedCaptureDuration != 0)
 			{
 				m_fSeizingStartTimestamp = world.GetServerTimestamp().PlusMilliseconds(-m_fInterruptedCaptureDuration);
 				m_fInterruptedCaptureDuration = 0;
 			}
-
-			int factionIndex = GetGame().GetFactionManager().GetFactionIndex(m_PrevailingFaction);
-			Rpc(RpcDo_OnCaptureStart, factionIndex);
-			RpcDo_OnCaptureStart(factionIndex);
 		}
 		
+		// Cached on the base, see Narco_CampaignMilitaryBaseComponent.c.
 		int servicesCount;
-		if (m_Base)
-		{
-			array<SCR_EServicePointType> checkedTypes = { SCR_EServicePointType.ARMORY, SCR_EServicePointType.HELIPAD, SCR_EServicePointType.BARRACKS, SCR_EServicePointType.RADIO_ANTENNA, SCR_EServicePointType.FIELD_HOSPITAL, SCR_EServicePointType.LIGHT_VEHICLE_DEPOT, SCR_EServicePointType.HEAVY_VEHICLE_DEPOT };
-			foreach (SCR_EServicePointType type : checkedTypes) { if (m_Base.GetServiceDelegateByType(type)) servicesCount++; }
-		}
-		
 		int radioConnectionsCount;
-		SCR_CoverageRadioComponent comp = SCR_CoverageRadioComponent.Cast(m_Base.GetOwner().FindComponent(SCR_CoverageRadioComponent));
-		if (comp)
+		if (m_Base)
 		{
-			SCR_CampaignFaction faction = m_Base.GetCampaignFaction();
-			if (faction && faction.IsPlayable()) radioConnectionsCount = comp.GetRadiosInRangeOfCount(faction.GetFactionRadioEncryptionKey());
+			servicesCount = m_Base.GetSeizingServicesCount();
+			radioConnectionsCount = m_Base.GetSeizingRadioConnectionsCount();
 		}
 
 		float seizingTimeVar = m_fMaximumSeizingTime - m_fMinimumSeizingTime;
@@ -301,9 +489,62 @@ modded class SCR_CampaignSeizingComponent : SCR_SeizingComponent
 		float finalSeizeTime = multiplier * (m_fMaximumSeizingTime - deduct);
 		m_fSeizingEndTimestamp = m_fSeizingStartTimestamp.PlusSeconds(finalSeizeTime);
 		
-		Print(string.Format("Majority Capture Mod: %1 Recalculated Seize Timer -> Players: %2, Services: %3, Radios: %4. Deduction: %.2fs, Multiplier: %.2fx, Final Time: %.2fs", m_sLogPrefix, m_iSeizingCharacters, servicesCount, radioConnectionsCount, deduct, multiplier, finalSeizeTime), LogLevel.NORMAL);
+		NarcoCaptureEventLog.RecordTimerRecalculated(m_iLogBaseIndex, m_PrevailingFaction, m_iSeizingCharacters, finalSeizeTime, servicesCount, radioConnectionsCount);
 		
+		RequestSeizingUpdate();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Replicates the seizing state, at most once per replication window.
+	protected void RequestSeizingUpdate()
+	{
+		if (m_bReplicationWindowOpen)
+		{
+			m_bReplicationPending = true;
+			return;
+		}
+		
+		SendSeizingUpdate();
+		m_bReplicationWindowOpen = true;
+		GetGame().GetCallqueue().CallLater(CloseReplicationWindow, m_fReplicationWindow_Config * 1000);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Sends what changed during the window. Sending opens the next window, so updates stay at one per window.
+	protected void CloseReplicationWindow()
+	{
+		m_bReplicationWindowOpen = false;
+		if (!m_bReplicationPending)
+			return;
+		
+		m_bReplicationPending = false;
+		RequestSeizingUpdate();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Replicates the current timestamps. Sends a capture start or interrupt only if the capture state differs from the last one sent.
+	protected void SendSeizingUpdate()
+	{
 		Replication.BumpMe();
 		OnSeizingTimestampChanged();
+		
+		bool isRunning = m_fSeizingStartTimestamp != 0 && m_fSeizingEndTimestamp != m_fSeizingStartTimestamp;
+		int factionIndex = -1;
+		if (isRunning && m_PrevailingFaction)
+			factionIndex = GetGame().GetFactionManager().GetFactionIndex(m_PrevailingFaction);
+		
+		if (isRunning && (!m_bSentCaptureRunning || factionIndex != m_iSentCaptureFactionIndex))
+		{
+			Rpc(RpcDo_OnCaptureStart, factionIndex);
+			RpcDo_OnCaptureStart(factionIndex);
+		}
+		else if (!isRunning && m_bSentCaptureRunning && m_fSeizingStartTimestamp != 0)
+		{
+			Rpc(RpcDo_OnCaptureInterrupt, m_iSentCaptureFactionIndex);
+			RpcDo_OnCaptureInterrupt(m_iSentCaptureFactionIndex);
+		}
+		
+		m_bSentCaptureRunning = isRunning;
+		m_iSentCaptureFactionIndex = factionIndex;
 	}
 }
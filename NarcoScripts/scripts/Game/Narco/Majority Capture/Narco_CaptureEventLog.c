@@ -0,0 +1,371 @@
+//------------------------------------------------------------------------------------------------
+// SCRIPT: Narco_CaptureEventLog.c
+// PURPOSE: Ring buffer of Majority Capture events, written to a rotating log file at a bounded rate.
+//------------------------------------------------------------------------------------------------
+
+enum NarcoECaptureEvent
+{
+	STATE_CHANGED,
+	TIMER_RECALCULATED,
+	CAPTURE_STARTED,
+	CAPTURE_INTERRUPTED,
+	CAPTURE_RESUMED
+}
+
+enum NarcoECaptureInterruptReason
+{
+	MAJORITY_LOST,
+	DEFENDERS_REGAINED_CONTROL,
+	NO_PREVAILING_FACTION
+}
+
+enum NarcoECaptureLogVerbosity
+{
+	OFF,
+	CAPTURES,	// Capture start, interrupt and resume.
+	ALL			// Also every majority change and timer recalculation.
+}
+
+// Recording only packs a few ints into preallocated arrays; the text is formatted when the events are flushed.
+// When the buffer is full the oldest unflushed event is overwritten and counted as dropped.
+class NarcoCaptureEventLog
+{
+	private static const int CAPACITY = 1024;
+	private static const int MAX_EVENTS_PER_FLUSH = 256;
+	private static const float DEFAULT_FLUSH_INTERVAL = 10;
+	private static const int DEFAULT_MAX_FILE_SIZE_KB = 1024;
+	private static const NarcoECaptureLogVerbosity DEFAULT_VERBOSITY = NarcoECaptureLogVerbosity.CAPTURES;
+	private static const string LOG_FILE_PATH = "$profile:NarcoCaptureEvents.log";
+	private static const string ROTATED_LOG_FILE_PATH = "$profile:NarcoCaptureEvents.1.log";
+	private static const string DUMP_FILE_PATH = "$profile:NarcoCaptureEvents_Dump.log";
+
+	// --- Events (parallel arrays) ---
+	// Header: type (4 bits) | faction index + 1 (8) | seizers (8) | base index (12).
+	// Value and detail depend on the type, see the Record* functions.
+	private static ref array<int> s_aHeaders;
+	private static ref array<int> s_aTimes;
+	private static ref array<int> s_aValues;
+	private static ref array<int> s_aDetails;
+	private static int s_iNext;
+	private static int s_iStored;
+	private static int s_iUnflushed;
+	private static int s_iDropped;
+
+	private static ref array<string> s_aBaseNames;
+
+	// --- Settings ---
+	private static bool s_bSettingsLoaded;
+	private static NarcoECaptureLogVerbosity s_eVerbosity;
+	private static float s_fFlushInterval;
+	private static int s_iMaxFileSize;
+	private static int s_iFileSize = -1;
+
+	//------------------------------------------------------------------------------------------------
+	//! Returns the index a base is recorded under. Server only.
+	static int RegisterBase(string baseName)
+	{
+		if (!s_aBaseNames)
+			s_aBaseNames = {};
+
+		int baseIndex = s_aBaseNames.Find(baseName);
+		if (baseIndex < 0)
+			baseIndex = s_aBaseNames.Insert(baseName);
+
+		return baseIndex;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Returns true if events of the given verbosity are recorded. Lets callers skip gathering event data.
+	static bool IsRecording(NarcoECaptureLogVerbosity verbosity)
+	{
+		if (!s_bSettingsLoaded)
+			LoadSettings();
+
+		return s_eVerbosity >= verbosity;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! The prevailing faction or seizer count changed. Value holds the previous faction index + 1 and seizer count.
+	static void RecordStateChanged(int baseIndex, Faction oldFaction, int oldSeizers, Faction newFaction, int newSeizers)
+	{
+		if (IsRecording(NarcoECaptureLogVerbosity.ALL))
+			Record(NarcoECaptureEvent.STATE_CHANGED, baseIndex, newFaction, newSeizers, (GetFactionIndex(oldFaction) + 1) | (Math.Min(oldSeizers, 0xFF) << 8), 0);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! The seizing timer was recalculated. Value holds the final seizing time in ms, detail the service and radio counts.
+	static void RecordTimerRecalculated(int baseIndex, Faction faction, int seizers, float seizingTime, int services, int radios)
+	{
+		if (IsRecording(NarcoECaptureLogVerbosity.ALL))
+			Record(NarcoECaptureEvent.TIMER_RECALCULATED, baseIndex, faction, seizers, seizingTime * 1000, Math.Min(services, 0xFF) | (Math.Min(radios, 0xFF) << 8));
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! A capture started after the majority was held. Value holds how long it was held in ms.
+	static void RecordCaptureStarted(int baseIndex, Faction faction, int seizers, float heldDuration)
+	{
+		if (IsRecording(NarcoECaptureLogVerbosity.CAPTURES))
+			Record(NarcoECaptureEvent.CAPTURE_STARTED, baseIndex, faction, seizers, heldDuration * 1000, 0);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! A running capture was paused. Value holds the reason.
+	static void RecordCaptureInterrupted(int baseIndex, Faction faction, int seizers, NarcoECaptureInterruptReason reason)
+	{
+		if (IsRecording(NarcoECaptureLogVerbosity.CAPTURES))
+			Record(NarcoECaptureEvent.CAPTURE_INTERRUPTED, baseIndex, faction, seizers, reason, 0);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! A paused capture continued.
+	static void RecordCaptureResumed(int baseIndex, Faction faction, int seizers)
+	{
+		if (IsRecording(NarcoECaptureLogVerbosity.CAPTURES))
+			Record(NarcoECaptureEvent.CAPTURE_RESUMED, baseIndex, faction, seizers, 0, 0);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Writes every event still in the buffer, flushed or not, to the dump file right away. Meant for the script console.
+	static void Dump()
+	{
+		if (!s_aHeaders)
+			return;
+
+		FileHandle file = FileIO.OpenFile(DUMP_FILE_PATH, FileMode.WRITE);
+		if (!file)
+		{
+			Print("Majority Capture Mod ERROR: Could not open the capture event dump file!", LogLevel.ERROR);
+			return;
+		}
+
+		int first = (s_iNext - s_iStored + CAPACITY) % CAPACITY;
+		for (int i = 0; i < s_iStored; i++)
+		{
+			file.WriteLine(FormatEvent((first + i) % CAPACITY));
+		}
+
+		file.Close();
+		Print(string.Format("Majority Capture Mod: Dumped %1 capture events to %2.", s_iStored, DUMP_FILE_PATH), LogLevel.NORMAL);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Writes every unflushed event to the log file right away, ignoring the per-flush limit. Called when the game ends.
+	static void FlushAll()
+	{
+		while (true)
+		{
+			int unflushed = s_iUnflushed;
+			Flush();
+			
+			// Also stops if the log file could not be opened.
+			if (s_iUnflushed == 0 || s_iUnflushed == unflushed)
+				break;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private static void Record(NarcoECaptureEvent type, int baseIndex, Faction faction, int seizers, int value, int detail)
+	{
+		if (!s_aHeaders)
+		{
+			s_aHeaders = {};
+			s_aTimes = {};
+			s_aValues = {};
+			s_aDetails = {};
+			s_aHeaders.Resize(CAPACITY);
+			s_aTimes.Resize(CAPACITY);
+			s_aValues.Resize(CAPACITY);
+			s_aDetails.Resize(CAPACITY);
+			GetGame().GetCallqueue().CallLater(Flush, s_fFlushInterval * 1000, true);
+		}
+
+		int header = type;
+		header |= (GetFactionIndex(faction) + 1) << 4;
+		header |= Math.Min(seizers, 0xFF) << 12;
+		header |= (baseIndex & 0xFFF) << 20;
+
+		s_aHeaders[s_iNext] = header;
+		s_aTimes[s_iNext] = GetGame().GetWorld().GetWorldTime();
+		s_aValues[s_iNext] = value;
+		s_aDetails[s_iNext] = detail;
+		s_iNext = (s_iNext + 1) % CAPACITY;
+
+		s_iStored = Math.Min(s_iStored + 1, CAPACITY);
+		if (s_iUnflushed == CAPACITY)
+			s_iDropped++;
+		else
+			s_iUnflushed++;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Called from the call queue. Appends at most MAX_EVENTS_PER_FLUSH events to the log file, the rest wait for the next flush.
+	private static void Flush()
+	{
+		if (s_iUnflushed == 0 && s_iDropped == 0)
+			return;
+
+		if (s_iFileSize < 0)
+			s_iFileSize = GetFileSize(LOG_FILE_PATH);
+
+		if (s_iFileSize >= s_iMaxFileSize)
+			RotateLogFile();
+
+		FileHandle file = FileIO.OpenFile(LOG_FILE_PATH, FileMode.APPEND);
+		if (!file)
+			return;
+
+		if (s_iDropped > 0)
+		{
+			string droppedLine = string.Format("%1 capture events dropped, the buffer was full.", s_iDropped);
+			file.WriteLine(droppedLine);
+			s_iFileSize += droppedLine.Length() + 1;
+			s_iDropped = 0;
+		}
+
+		int count = Math.Min(s_iUnflushed, MAX_EVENTS_PER_FLUSH);
+		int first = (s_iNext - s_iUnflushed + CAPACITY) % CAPACITY;
+		for (int i = 0; i < count; i++)
+		{
+			string line = FormatEvent((first + i) % CAPACITY);
+			file.WriteLine(line);
+			s_iFileSize += line.Length() + 1;
+		}
+
+		s_iUnflushed -= count;
+		file.Close();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Keeps one previous log file. FileIO has no rename, so the current file is copied over it and started anew.
+	private static void RotateLogFile()
+	{
+		FileIO.CopyFile(LOG_FILE_PATH, ROTATED_LOG_FILE_PATH);
+		FileIO.DeleteFile(LOG_FILE_PATH);
+		s_iFileSize = 0;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private static string FormatEvent(int index)
+	{
+		int header = s_aHeaders[index];
+		NarcoECaptureEvent type = header & 0xF;
+		string factionKey = GetFactionKey(((header >> 4) & 0xFF) - 1);
+		int seizers = (header >> 12) & 0xFF;
+		string baseName = s_aBaseNames[(header >> 20) & 0xFFF];
+		int value = s_aValues[index];
+		int detail = s_aDetails[index];
+
+		string eventText;
+		switch (type)
+		{
+			case NarcoECaptureEvent.STATE_CHANGED:
+				eventText = string.Format("StateChanged - Faction: %1 -> %2, Seizers: %3 -> %4", GetFactionKey((value & 0xFF) - 1), factionKey, (value >> 8) & 0xFF, seizers);
+				break;
+			case NarcoECaptureEvent.TIMER_RECALCULATED:
+				eventText = string.Format("Recalculated Seize Timer -> Faction: %1, Players: %2, Services: %3, Radios: %4, Final Time: %5s", factionKey, seizers, detail & 0xFF, (detail >> 8) & 0xFF, value / 1000.0);
+				break;
+			case NarcoECaptureEvent.CAPTURE_STARTED:
+				eventText = string.Format("Majority held (%1s), starting capture for %2 with %3 seizers.", value / 1000.0, factionKey, seizers);
+				break;
+			case NarcoECaptureEvent.CAPTURE_INTERRUPTED:
+				eventText = string.Format("Capture interrupted for %1. Reason: %2.", factionKey, typename.EnumToString(NarcoECaptureInterruptReason, value));
+				break;
+			case NarcoECaptureEvent.CAPTURE_RESUMED:
+				eventText = string.Format("Capture resumed for %1 with %2 seizers.", factionKey, seizers);
+				break;
+		}
+
+		return string.Format("[%1s] [CSB:%2] %3", s_aTimes[index] / 1000.0, baseName, eventText);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private static int GetFactionIndex(Faction faction)
+	{
+		if (!faction)
+			return -1;
+
+		return GetGame().GetFactionManager().GetFactionIndex(faction);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private static string GetFactionKey(int factionIndex)
+	{
+		if (factionIndex < 0)
+			return "null";
+
+		Faction faction = GetGame().GetFactionManager().GetFactionByIndex(factionIndex);
+		if (!faction)
+			return "null";
+
+		return faction.GetFactionKey();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Returns the size of a file in bytes, or 0 if it can't be opened.
+	private static int GetFileSize(string filePath)
+	{
+		FileHandle file = FileIO.OpenFile(filePath, FileMode.READ);
+		if (!file)
+			return 0;
+
+		int fileSize = file.GetLength();
+		file.Close();
+		return fileSize;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Reads the log settings and follows later config reloads.
+	private static void LoadSettings()
+	{
+		s_bSettingsLoaded = true;
+		ApplySettings(null);
+		NarcoSettingsSnapshot.GetOnPublished().Insert(ApplySettings);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private static void ApplySettings(NarcoSettingsSnapshot snapshot)
+	{
+		NarcoMajorityCaptureSettings settings = NarcoJsonSettingsManager.GetInstance().GetMajorityCaptureSettings();
+		// Older config files do not have the verbosity yet, so 0 means the default and a negative value turns logging off.
+		int verbosity = settings.m_iCaptureLogVerbosity;
+		if (verbosity < 0)
+			s_eVerbosity = NarcoECaptureLogVerbosity.OFF;
+		else if (verbosity == 0)
+			s_eVerbosity = DEFAULT_VERBOSITY;
+		else
+			s_eVerbosity = Math.ClampInt(verbosity, NarcoECaptureLogVerbosity.CAPTURES, NarcoECaptureLogVerbosity.ALL);
+
+		float flushInterval = settings.m_fCaptureLogFlushInterval;
+		if (flushInterval <= 0)
+			flushInterval = DEFAULT_FLUSH_INTERVAL;
+
+		int maxFileSizeKB = settings.m_iCaptureLogMaxFileSizeKB;
+		if (maxFileSizeKB <= 0)
+			maxFileSizeKB = DEFAULT_MAX_FILE_SIZE_KB;
+
+		s_iMaxFileSize = maxFileSizeKB * 1024;
+
+		// A running flush timer picks up a new interval.
+		if (s_aHeaders && flushInterval != s_fFlushInterval)
+		{
+			GetGame().GetCallqueue().Remove(Flush);
+			GetGame().GetCallqueue().CallLater(Flush, flushInterval * 1000, true);
+		}
+
+		s_fFlushInterval = flushInterval;
+	}
+}
+
+
+// --- Writes the events of the last flush interval before the game mode ends ---
+modded class SCR_BaseGameMode
+{
+	//------------------------------------------------------------------------------------------------
+	override void OnGameModeEnd(SCR_GameModeEndData endData)
+	{
+		super.OnGameModeEnd(endData);
+
+		if (IsMaster())
+			NarcoCaptureEventLog.FlushAll();
+	}
+}
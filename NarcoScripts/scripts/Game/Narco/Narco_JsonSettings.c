@@ -15,14 +15,41 @@ class NarcoPersistentRankSettings
 	[Attribute("true", desc: "If true, the Loadout Cleaner script will run during a wipe.")]
 	bool m_bLoadoutCleaning;
 	
+	[Attribute("10", desc: "Maximum number of loadout files cleaned per frame. Cleaning runs in the background and resumes after a restart.")]
+	int m_iLoadoutCleaningFilesPerFrame;
+	
 	[Attribute("7", desc: "The interval in days for how often player XP and loadouts should be wiped.")]
 	int m_iWipeIntervalDays;
 	
 	[Attribute("0", desc: "The timestamp (in UTC seconds) of the last successful wipe. Do not change manually.")]
 	int m_iLastWipeTimestampUTC;
 	
+	[Attribute("0", desc: "Current XP wipe generation. Saved XP from older generations is ignored. Do not change manually.")]
+	int m_iWipeGeneration;
+	
+	[Attribute("0", desc: "Wipe generation up to which stale XP data has been deleted from disk. Do not change manually.")]
+	int m_iCollectedWipeGeneration;
+	
 	[Attribute("7.0", desc: "Global multiplier for the XP required for each rank. 1.0 = default, 2.0 = double XP needed, etc.")]
 	float m_fRankXPMultiplier;
+	
+	[Attribute("4", desc: "Maximum number of player XP files written per frame during a periodic save.")]
+	int m_iSaveWritesPerFrame;
+	
+	[Attribute("10", desc: "Interval in seconds at which changed XP is appended to a small write-ahead log. Bounds the XP lost on a server crash without shortening the full save interval.")]
+	float m_fWriteAheadIntervalSeconds;
+	
+	[Attribute("json", desc: "XP storage backend. \"json\" = one file per player, \"journal\" = single append-only journal with periodic compaction.")]
+	string m_sStorageBackend;
+	
+	[Attribute("10000", desc: "Journal backend only. Number of journal records after which the journal is compacted into a snapshot.")]
+	int m_iJournalCompactionThreshold;
+	
+	[Attribute("false", desc: "If true, stored XP is preloaded over several frames instead of all at once during startup. Useful for very large data sets.")]
+	bool m_bIncrementalPreload;
+	
+	[Attribute("50", desc: "Number of player XP files preloaded per frame when incremental preload is enabled.")]
+	int m_iPreloadFilesPerFrame;
 }
 
 [BaseContainerProps(), SCR_BaseContainerCustomTitleField("m_sComment")]
@@ -37,6 +64,24 @@ class NarcoSquadXPSettings
     
     [Attribute("150", UIWidgets.EditBox, "The time in seconds a player must be near squadmates to earn XP.", "1 3600")]
     float m_fXpInterval;
+    
+    [Attribute("4", UIWidgets.EditBox, "How many times per second the squad XP system is evaluated on the server.", "0.1 30")]
+    float m_fEvaluationRate;
+    
+    [Attribute("4", UIWidgets.EditBox, "Number of evaluation ticks the player list is spread across. Each player is evaluated once every N ticks.", "1 64")]
+    int m_iEvaluationSlices;
+    
+    [Attribute("30", UIWidgets.EditBox, "Maximum XP a squad member can earn per interval from the Squad Cohesion bonus.", "0 1000")]
+    float m_fSquadCohesionCap;
+    
+    [Attribute("50", UIWidgets.EditBox, "Maximum XP a squad leader can earn per interval from the Squad Leading bonus.", "0 1000")]
+    float m_fSquadLeadingCap;
+    
+    [Attribute("7", UIWidgets.EditBox, "Number of nearby squadmates at which the bonus reaches its cap.", "2 32")]
+    int m_iMaxSquadMembersForBonus;
+    
+    [Attribute("false", desc: "If true, the expected payout schedule is printed to the log when the game mode starts.")]
+    bool m_bLogPayoutSchedule;
 }
 
 [BaseContainerProps(), SCR_BaseContainerCustomTitleField("m_sComment")]
@@ -51,6 +96,30 @@ class NarcoMajorityCaptureSettings
 	
 	[Attribute("1.0", uiwidget: UIWidgets.EditBox, desc: "Time in seconds the majority must be held consistently before capture starts/resumes.")]
 	float m_fMajorityDebounceTime;
+	
+	[Attribute("false", desc: "If true, capture points always query their trigger at the full rate. By default, points with nobody within the wake radius query at a reduced rate.")]
+	bool m_bDisableIdleBackoff;
+	
+	[Attribute("5.0", uiwidget: UIWidgets.EditBox, desc: "Time in seconds between trigger queries of an idle capture point.")]
+	float m_fIdleQueryInterval;
+	
+	[Attribute("250", uiwidget: UIWidgets.EditBox, desc: "Radius in meters around an idle capture point. A character inside it restores the full query rate.")]
+	float m_fWakeRadius;
+	
+	[Attribute("1.0", uiwidget: UIWidgets.EditBox, desc: "Time in seconds between checks of the wake radius of an idle capture point.")]
+	float m_fWakeCheckInterval;
+	
+	[Attribute("1", uiwidget: UIWidgets.EditBox, desc: "Capture event log verbosity. -1 = off, 1 = capture start, interrupt and resume, 2 = also every majority change and timer recalculation. 0 uses the default of 1.")]
+	int m_iCaptureLogVerbosity;
+	
+	[Attribute("10.0", uiwidget: UIWidgets.EditBox, desc: "Time in seconds between writes of buffered capture events to $profile:NarcoCaptureEvents.log.")]
+	float m_fCaptureLogFlushInterval;
+	
+	[Attribute("1024", uiwidget: UIWidgets.EditBox, desc: "Size in KB at which the capture event log is rotated to NarcoCaptureEvents.1.log.")]
+	int m_iCaptureLogMaxFileSizeKB;
+	
+	[Attribute("0.5", uiwidget: UIWidgets.EditBox, desc: "Time in seconds over which seizing timer changes of a base are merged into a single replicated update.")]
+	float m_fReplicationWindow;
 }
 
 [BaseContainerProps(), SCR_BaseContainerCustomTitleField("m_sComment")]
@@ -90,6 +159,27 @@ class NarcoFovAndZoomSettings
 	float m_fZoomCooldown;
 }
 
+[BaseContainerProps()]
+class NarcoBlockedPrefab
+{
+	[Attribute("", desc: "Prefab GUID, 16 hex characters.")]
+	string m_sGuid;
+	
+	[Attribute("", desc: "Readable name of the prefab. Only used for logging and to keep the list maintainable.")]
+	string m_sName;
+}
+
+[BaseContainerProps(), SCR_BaseContainerCustomTitleField("m_sComment")]
+class NarcoLoadoutCleanerSettings
+{
+	
+	[Attribute("true", desc: "If true, blocked prefabs are removed from a player who spawns with a saved loadout. Faction role loadouts are left alone.")]
+	bool m_bSanitizeOnSpawn;
+	
+	[Attribute(desc: "Prefabs removed from saved loadouts. Edits are picked up without a restart. If the list is missing from the config it is filled with the built-in defaults.")]
+	ref array<ref NarcoBlockedPrefab> m_aBlockedPrefabs;
+}
+
 
 // --- Main Config Container ---
 [BaseContainerProps(configRoot: true)]
@@ -110,6 +200,9 @@ class NarcoJsonSettings
 	[Attribute()]
 	ref NarcoFovAndZoomSettings m_FovAndZoomSettings;
 	
+	[Attribute()]
+	ref NarcoLoadoutCleanerSettings m_LoadoutCleanerSettings;
+	
 	void NarcoJsonSettings()
 	{
 		m_PersistentRankSettings = new NarcoPersistentRankSettings();
@@ -117,6 +210,7 @@ class NarcoJsonSettings
 		m_MajorityCaptureSettings = new NarcoMajorityCaptureSettings();
 		m_MOBSpawnsSettings = new NarcoMOBSpawnsSettings();
 		m_FovAndZoomSettings = new NarcoFovAndZoomSettings();
+		m_LoadoutCleanerSettings = new NarcoLoadoutCleanerSettings();
 	}
 }
 
@@ -145,9 +239,13 @@ class SCR_PrettyJsonSaveContext : ContainerSerializationSaveContext
 class NarcoJsonSettingsManager
 {
 	private const string SETTINGS_FILE_PATH = "$profile:narco_script_config.json";
+	private const float WATCH_INTERVAL_SECONDS = 10;
 	
 	private static ref NarcoJsonSettings s_Settings;
 	private static ref NarcoJsonSettingsManager s_Instance;
+	
+	// Hash of the config file as last read or written by us. Our own saves update it, so they never trigger a reload.
+	private static int s_iFileHash;
 
 	//------------------------------------------------------------------------------------------------
 	static NarcoJsonSettingsManager GetInstance()
@@ -167,6 +265,7 @@ class NarcoJsonSettingsManager
 	NarcoMajorityCaptureSettings GetMajorityCaptureSettings() { return s_Settings.m_MajorityCaptureSettings; }
 	NarcoMOBSpawnsSettings GetMOBSpawnsSettings() { return s_Settings.m_MOBSpawnsSettings; }
 	NarcoFovAndZoomSettings GetFovAndZoomSettings() { return s_Settings.m_FovAndZoomSettings; }
+	NarcoLoadoutCleanerSettings GetLoadoutCleanerSettings() { return s_Settings.m_LoadoutCleanerSettings; }
 
 	//------------------------------------------------------------------------------------------------
 	void LoadSettings()
@@ -187,12 +286,173 @@ class NarcoJsonSettingsManager
 			else
 			{
 				Print("Narco QOL Mods: Successfully loaded settings from narco_script_config.json", LogLevel.NORMAL);
+				s_iFileHash = GetFileHash();
+				
+				// Configs written before the blocklist moved into the config don't have it yet.
+				if (!s_Settings.m_LoadoutCleanerSettings.m_aBlockedPrefabs)
+				{
+					s_Settings.m_LoadoutCleanerSettings.m_bSanitizeOnSpawn = true;
+					s_Settings.m_LoadoutCleanerSettings.m_aBlockedPrefabs = {};
+					LoadoutCleaner.AddDefaultBlockedPrefabs(s_Settings.m_LoadoutCleanerSettings.m_aBlockedPrefabs);
+					SaveSettings();
+				}
 			}
 		}
 		else
 		{
 			CreateDefaultSettingsFile();
 		}
+		
+		NarcoSettingsSnapshot.Publish(s_Settings);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Starts polling the config file for edits. Server only, clients never reload their settings.
+	void WatchForChanges()
+	{
+		GetGame().GetCallqueue().Remove(CheckForChanges);
+		GetGame().GetCallqueue().CallLater(CheckForChanges, WATCH_INTERVAL_SECONDS * 1000, true);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Reloads the settings if the file content changed since it was last read or written.
+	//! FileIO exposes no modification time, so the content hash stands in for it. The file is a few KB.
+	private void CheckForChanges()
+	{
+		if (!FileIO.FileExists(SETTINGS_FILE_PATH))
+			return;
+		
+		int fileHash = GetFileHash();
+		if (fileHash == s_iFileHash)
+			return;
+		
+		// Remembered even if the reload fails, so a broken file is reported once and not every poll.
+		s_iFileHash = fileHash;
+		ReloadSettings();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Parses and validates the config file into a new settings object and swaps it in.
+	//! Returns false and keeps the current settings if the file can't be read or fails validation.
+	bool ReloadSettings()
+	{
+		NarcoJsonSettings loadedSettings = new NarcoJsonSettings();
+		SCR_JsonLoadContext loadContext = new SCR_JsonLoadContext();
+		if (!loadContext.LoadFromFile(SETTINGS_FILE_PATH) || !loadContext.ReadValue("", loadedSettings))
+		{
+			Print("Narco QOL Mods ERROR: Failed to parse the edited config file! Keeping the current settings.", LogLevel.ERROR);
+			return false;
+		}
+		
+		string error;
+		if (!ValidateSettings(loadedSettings, error))
+		{
+			Print(string.Format("Narco QOL Mods ERROR: Edited config file is invalid (%1)! Keeping the current settings.", error), LogLevel.ERROR);
+			return false;
+		}
+		
+		// Wipe bookkeeping is written by the mod itself, the in-memory values are the current ones.
+		NarcoPersistentRankSettings rankSettings = loadedSettings.m_PersistentRankSettings;
+		rankSettings.m_iLastWipeTimestampUTC = s_Settings.m_PersistentRankSettings.m_iLastWipeTimestampUTC;
+		rankSettings.m_iWipeGeneration = s_Settings.m_PersistentRankSettings.m_iWipeGeneration;
+		rankSettings.m_iCollectedWipeGeneration = s_Settings.m_PersistentRankSettings.m_iCollectedWipeGeneration;
+		
+		if (!loadedSettings.m_LoadoutCleanerSettings.m_aBlockedPrefabs)
+			loadedSettings.m_LoadoutCleanerSettings.m_aBlockedPrefabs = s_Settings.m_LoadoutCleanerSettings.m_aBlockedPrefabs;
+		
+		s_Settings = loadedSettings;
+		Print("Narco QOL Mods: Reloaded settings from narco_script_config.json", LogLevel.NORMAL);
+		
+		NarcoSettingsSnapshot.Publish(s_Settings);
+		return true;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Checks the values that would break a running subsystem. Older files may lack newer fields, those fall back to defaults later.
+	private bool ValidateSettings(NarcoJsonSettings settings, out string error)
+	{
+		if (!settings.m_PersistentRankSettings || !settings.m_SquadXPSettings || !settings.m_MajorityCaptureSettings
+			|| !settings.m_MOBSpawnsSettings || !settings.m_FovAndZoomSettings || !settings.m_LoadoutCleanerSettings)
+		{
+			error = "a settings section is missing";
+			return false;
+		}
+		
+		if (settings.m_PersistentRankSettings.m_fRankXPMultiplier < 0)
+		{
+			error = "m_fRankXPMultiplier is negative";
+			return false;
+		}
+		
+		if (settings.m_PersistentRankSettings.m_sStorageBackend != s_Settings.m_PersistentRankSettings.m_sStorageBackend)
+		{
+			error = "m_sStorageBackend can only be changed with a restart";
+			return false;
+		}
+		
+		if (settings.m_SquadXPSettings.m_iProximityDistance < 0 || settings.m_SquadXPSettings.m_fXpInterval <= 0)
+		{
+			error = "m_iProximityDistance must not be negative and m_fXpInterval must be positive";
+			return false;
+		}
+		
+		if (settings.m_MajorityCaptureSettings.m_fMajorityDebounceTime < 0)
+		{
+			error = "m_fMajorityDebounceTime is negative";
+			return false;
+		}
+		
+		NarcoFovAndZoomSettings fovSettings = settings.m_FovAndZoomSettings;
+		if (fovSettings.m_fMinFOV <= 0 || fovSettings.m_fMinFOV > fovSettings.m_fMaxFOV)
+		{
+			error = "m_fMinFOV must be positive and not above m_fMaxFOV";
+			return false;
+		}
+		
+		// Clients receive these packed into fixed-width fields, see NarcoSettingsSnapshot.PackClientBlock().
+		if (fovSettings.m_fMaxFOV > NarcoSettingsSnapshot.CLIENT_BLOCK_MAX_FOV)
+		{
+			error = string.Format("m_fMaxFOV must not be above %1", NarcoSettingsSnapshot.CLIENT_BLOCK_MAX_FOV);
+			return false;
+		}
+		
+		if (!IsUnitRange(fovSettings.m_fMaxAdsIntensity) || !IsUnitRange(fovSettings.m_fMaxPipIntensity) || !IsUnitRange(fovSettings.m_fZoomAmount))
+		{
+			error = "m_fMaxAdsIntensity, m_fMaxPipIntensity and m_fZoomAmount must be between 0 and 1";
+			return false;
+		}
+		
+		if (fovSettings.m_fZoomDuration < 0 || fovSettings.m_fZoomCooldown < 0)
+		{
+			error = "m_fZoomDuration and m_fZoomCooldown must not be negative";
+			return false;
+		}
+		
+		return true;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	private static bool IsUnitRange(float value)
+	{
+		return value >= 0 && value <= 1;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	private int GetFileHash()
+	{
+		FileHandle file = FileIO.OpenFile(SETTINGS_FILE_PATH, FileMode.READ);
+		if (!file)
+			return 0;
+		
+		int fileHash = 0;
+		string chunk;
+		while (file.Read(chunk, 4096) > 0)
+		{
+			fileHash = fileHash * 31 + chunk.Hash();
+		}
+		
+		file.Close();
+		return fileHash;
 	}
 	
 	//------------------------------------------------------------------------------------------------
@@ -206,7 +466,12 @@ class NarcoJsonSettingsManager
 		saveContext.WriteValue("", s_Settings);
 		
 		if (!saveContext.SaveToFile(SETTINGS_FILE_PATH))
+		{
 			Print("Narco QOL Mods ERROR: Failed to save config file!", LogLevel.ERROR);
+			return;
+		}
+		
+		s_iFileHash = GetFileHash();
 	}
 	
 	//------------------------------------------------------------------------------------------------
@@ -218,17 +483,40 @@ class NarcoJsonSettingsManager
 		// --- Manually set the desired default values ---		
 		s_Settings.m_PersistentRankSettings.m_bEnabled = true;
 		s_Settings.m_PersistentRankSettings.m_bLoadoutCleaning = true;
+		s_Settings.m_PersistentRankSettings.m_iLoadoutCleaningFilesPerFrame = 10;
 		s_Settings.m_PersistentRankSettings.m_iWipeIntervalDays = 7;
 		s_Settings.m_PersistentRankSettings.m_fRankXPMultiplier = 5.0;
 		s_Settings.m_PersistentRankSettings.m_iLastWipeTimestampUTC = System.GetUnixTime();
+		s_Settings.m_PersistentRankSettings.m_iWipeGeneration = 0;
+		s_Settings.m_PersistentRankSettings.m_iCollectedWipeGeneration = 0;
+		s_Settings.m_PersistentRankSettings.m_iSaveWritesPerFrame = 4;
+		s_Settings.m_PersistentRankSettings.m_fWriteAheadIntervalSeconds = 10;
+		s_Settings.m_PersistentRankSettings.m_sStorageBackend = NarcoXPJsonStorage.BACKEND_NAME;
+		s_Settings.m_PersistentRankSettings.m_iJournalCompactionThreshold = 10000;
+		s_Settings.m_PersistentRankSettings.m_bIncrementalPreload = false;
+		s_Settings.m_PersistentRankSettings.m_iPreloadFilesPerFrame = 50;
 		
 		s_Settings.m_SquadXPSettings.m_bEnabled = true;
 		s_Settings.m_SquadXPSettings.m_iProximityDistance = 50;
 		s_Settings.m_SquadXPSettings.m_fXpInterval = 150;
+		s_Settings.m_SquadXPSettings.m_fEvaluationRate = 4;
+		s_Settings.m_SquadXPSettings.m_iEvaluationSlices = 4;
+		s_Settings.m_SquadXPSettings.m_fSquadCohesionCap = 30;
+		s_Settings.m_SquadXPSettings.m_fSquadLeadingCap = 50;
+		s_Settings.m_SquadXPSettings.m_iMaxSquadMembersForBonus = 7;
+		s_Settings.m_SquadXPSettings.m_bLogPayoutSchedule = false;
 		
 		s_Settings.m_MajorityCaptureSettings.m_bEnabled = true;
 		s_Settings.m_MajorityCaptureSettings.m_iRequiredSeizingMajority = 4;
 		s_Settings.m_MajorityCaptureSettings.m_fMajorityDebounceTime = 1.0;
+		s_Settings.m_MajorityCaptureSettings.m_bDisableIdleBackoff = false;
+		s_Settings.m_MajorityCaptureSettings.m_fIdleQueryInterval = 5.0;
+		s_Settings.m_MajorityCaptureSettings.m_fWakeRadius = 250;
+		s_Settings.m_MajorityCaptureSettings.m_fWakeCheckInterval = 1.0;
+		s_Settings.m_MajorityCaptureSettings.m_iCaptureLogVerbosity = 1;
+		s_Settings.m_MajorityCaptureSettings.m_fCaptureLogFlushInterval = 10.0;
+		s_Settings.m_MajorityCaptureSettings.m_iCaptureLogMaxFileSizeKB = 1024;
+		s_Settings.m_MajorityCaptureSettings.m_fReplicationWindow = 0.5;
 		
 		s_Settings.m_MOBSpawnsSettings.m_bEnabled = true;
 		
@@ -241,6 +529,10 @@ class NarcoJsonSettingsManager
 		s_Settings.m_FovAndZoomSettings.m_fZoomDuration = 4.0;
 		s_Settings.m_FovAndZoomSettings.m_fZoomCooldown = 10.0;
 		
+		s_Settings.m_LoadoutCleanerSettings.m_bSanitizeOnSpawn = true;
+		s_Settings.m_LoadoutCleanerSettings.m_aBlockedPrefabs = {};
+		LoadoutCleaner.AddDefaultBlockedPrefabs(s_Settings.m_LoadoutCleanerSettings.m_aBlockedPrefabs);
+		
 		SaveSettings();
 	}
 }
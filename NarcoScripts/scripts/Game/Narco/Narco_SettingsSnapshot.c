@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------------------------
+// SCRIPT: Narco_SettingsSnapshot.c
+// PURPOSE: Flattened, read-only copy of the settings read on hot paths, published once per (re)load.
+//------------------------------------------------------------------------------------------------
+
+typedef func NarcoOnSettingsPublished;
+void NarcoOnSettingsPublished(NarcoSettingsSnapshot snapshot);
+
+// A snapshot is never modified after it is published. A (re)load builds a new one and swaps the reference,
+// so hot paths read plain fields instead of going through the settings manager every call.
+// Clients never read the config file. Their snapshot is the block replicated by the server, see PackClientBlock().
+class NarcoSettingsSnapshot
+{
+	private static ref NarcoSettingsSnapshot s_Current;
+	private static ref ScriptInvokerBase<NarcoOnSettingsPublished> s_OnPublished;
+	
+	// --- Client block layout ---
+	// Header: version (4 bits), feature flags (3), min FOV (11, tenths of a degree), max FOV (11, tenths of a degree).
+	// Limits: zoom amount (7, hundredths), max ADS intensity (7, hundredths), max PIP intensity (7, hundredths).
+	// The zoom duration and cooldown have no useful upper bound, so they are sent as plain floats next to the block.
+	// NarcoJsonSettingsManager rejects values the packed fields can't hold. Bump the version whenever the layout changes.
+	static const int CLIENT_BLOCK_VERSION = 2;
+	static const float CLIENT_BLOCK_MAX_FOV = 180;
+	private static const int FLAG_FOV_AND_ZOOM = 1;
+	private static const int FLAG_PERSISTENT_RANK = 2;
+	private static const int FLAG_MOB_SPAWNS = 4;
+
+	// --- Persistent Rank ---
+	bool m_bPersistentRankEnabled;
+	float m_fRankXPMultiplier;
+
+	// --- MOB Spawns ---
+	bool m_bMOBSpawnsEnabled;
+
+	// --- FOV and Zoom ---
+	bool m_bFovAndZoomEnabled;
+	float m_fMinFOV;
+	float m_fMaxFOV;
+	float m_fMaxAdsIntensity;
+	float m_fMaxPipIntensity;
+	float m_fZoomAmount;
+	float m_fZoomDuration;
+	float m_fZoomCooldown;
+
+	//------------------------------------------------------------------------------------------------
+	//! Returns the current snapshot. Loads the settings on first use.
+	//! Until the server's block arrives, clients get a snapshot with every feature disabled.
+	static NarcoSettingsSnapshot Get()
+	{
+		if (!s_Current)
+		{
+			if (RplSession.Mode() == RplMode.Client)
+				s_Current = new NarcoSettingsSnapshot();
+			else
+				NarcoJsonSettingsManager.GetInstance();
+		}
+
+		return s_Current;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Invoked with the new snapshot every time one is published.
+	static ScriptInvokerBase<NarcoOnSettingsPublished> GetOnPublished()
+	{
+		if (!s_OnPublished)
+			s_OnPublished = new ScriptInvokerBase<NarcoOnSettingsPublished>();
+
+		return s_OnPublished;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Builds a snapshot from the loaded settings and makes it current.
+	static void Publish(notnull NarcoJsonSettings settings)
+	{
+		NarcoSettingsSnapshot snapshot = new NarcoSettingsSnapshot();
+
+		snapshot.m_bPersistentRankEnabled = settings.m_PersistentRankSettings.m_bEnabled;
+		snapshot.m_fRankXPMultiplier = settings.m_PersistentRankSettings.m_fRankXPMultiplier;
+
+		snapshot.m_bMOBSpawnsEnabled = settings.m_MOBSpawnsSettings.m_bEnabled;
+
+		NarcoFovAndZoomSettings fovSettings = settings.m_FovAndZoomSettings;
+		snapshot.m_bFovAndZoomEnabled = fovSettings.m_bEnabled;
+		snapshot.m_fMinFOV = fovSettings.m_fMinFOV;
+		snapshot.m_fMaxFOV = fovSettings.m_fMaxFOV;
+		snapshot.m_fMaxAdsIntensity = fovSettings.m_fMaxAdsIntensity;
+		snapshot.m_fMaxPipIntensity = fovSettings.m_fMaxPipIntensity;
+		snapshot.m_fZoomAmount = fovSettings.m_fZoomAmount;
+		snapshot.m_fZoomDuration = fovSettings.m_fZoomDuration;
+		snapshot.m_fZoomCooldown = fovSettings.m_fZoomCooldown;
+
+		SetCurrent(snapshot);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Packs the fields clients need into two ints. Values are clamped to what their bit fields can hold.
+	//! The zoom duration and cooldown are not part of the block, send m_fZoomDuration and m_fZoomCooldown along with it.
+	void PackClientBlock(out int header, out int limits)
+	{
+		int flags = 0;
+		if (m_bFovAndZoomEnabled)
+			flags |= FLAG_FOV_AND_ZOOM;
+
+		if (m_bPersistentRankEnabled)
+			flags |= FLAG_PERSISTENT_RANK;
+
+		if (m_bMOBSpawnsEnabled)
+			flags |= FLAG_MOB_SPAWNS;
+
+		header = CLIENT_BLOCK_VERSION;
+		header |= flags << 4;
+		header |= PackField(m_fMinFOV, 10, 0x7FF) << 7;
+		header |= PackField(m_fMaxFOV, 10, 0x7FF) << 18;
+
+		limits = PackField(m_fZoomAmount, 100, 0x7F);
+		limits |= PackField(m_fMaxAdsIntensity, 100, 0x7F) << 7;
+		limits |= PackField(m_fMaxPipIntensity, 100, 0x7F) << 14;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Rebuilds a snapshot from a block made by PackClientBlock(). Returns null if the block has another layout version.
+	static NarcoSettingsSnapshot UnpackClientBlock(int header, int limits, float rankXPMultiplier, float zoomDuration, float zoomCooldown)
+	{
+		if ((header & 0xF) != CLIENT_BLOCK_VERSION)
+			return null;
+
+		NarcoSettingsSnapshot snapshot = new NarcoSettingsSnapshot();
+
+		int flags = (header >> 4) & 0x7;
+		snapshot.m_bFovAndZoomEnabled = (flags & FLAG_FOV_AND_ZOOM) != 0;
+		snapshot.m_bPersistentRankEnabled = (flags & FLAG_PERSISTENT_RANK) != 0;
+		snapshot.m_bMOBSpawnsEnabled = (flags & FLAG_MOB_SPAWNS) != 0;
+		snapshot.m_fRankXPMultiplier = rankXPMultiplier;
+
+		snapshot.m_fMinFOV = ((header >> 7) & 0x7FF) / 10.0;
+		snapshot.m_fMaxFOV = ((header >> 18) & 0x7FF) / 10.0;
+
+		snapshot.m_fZoomAmount = (limits & 0x7F) / 100.0;
+		snapshot.m_fMaxAdsIntensity = ((limits >> 7) & 0x7F) / 100.0;
+		snapshot.m_fMaxPipIntensity = ((limits >> 14) & 0x7F) / 100.0;
+		snapshot.m_fZoomDuration = zoomDuration;
+		snapshot.m_fZoomCooldown = zoomCooldown;
+
+		return snapshot;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Makes a snapshot received from the server current. Client only.
+	static void PublishReplicated(notnull NarcoSettingsSnapshot snapshot)
+	{
+		SetCurrent(snapshot);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private static void SetCurrent(NarcoSettingsSnapshot snapshot)
+	{
+		s_Current = snapshot;
+
+		if (s_OnPublished)
+			s_OnPublished.Invoke(snapshot);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private static int PackField(float value, float scale, int mask)
+	{
+		return Math.Clamp(Math.Round(value * scale), 0, mask);
+	}
+}
@@ -9,6 +9,9 @@ class PersistentXPData
 {
 	[Attribute("0", desc: "Player's total experience points at the time of saving.")]
 	int m_iTotalXP;
+	
+	[Attribute("0", desc: "Wipe generation the record was saved in. Records from older generations are ignored.")]
+	int m_iWipeGeneration;
 }
 
 
@@ -16,9 +19,31 @@ class PersistentXPData
 class PersistentXPManager
 {
 	private const string XP_SAVE_PATH = "$profile:PersistentXPData/";
+	private const string WRITE_AHEAD_LOG_PATH = "$profile:PersistentXPData/xp_wal.txt";
 	private const float PERIODIC_SAVE_INTERVAL_SECONDS = 300;
+	private const int DEFAULT_SAVE_WRITES_PER_FRAME = 4;
+	private const float STALE_COLLECTION_DELAY_SECONDS = 120;
+	private const int STALE_COLLECTION_FILES_PER_FRAME = 20;
+	private const float DEFAULT_WRITE_AHEAD_INTERVAL_SECONDS = 10;
 	
 	private static ref PersistentXPManager s_Instance;
+	
+	private ref NarcoXPStorage m_Storage;
+	
+	// --- Save batching ---
+	private ref set<int> m_DirtyPlayerIDs = new set<int>();
+	private ref map<int, int> m_mLastSavedXP = new map<int, int>();
+	// The queue is walked with an index and cleared once it is written out. Entries before the index are done.
+	private ref array<int> m_aSaveQueue = {};
+	private int m_iSaveQueueIndex;
+	private ref array<int> m_aSaveBatch = {};
+	private int m_iSaveWritesPerFrame;
+	private bool m_bSaveQueueRunning;
+	
+	// --- Write-ahead log ---
+	// "<guid> <xp> <generation>" lines holding absolute totals, so replaying a record twice is harmless.
+	// A player's XP is logged before it is stored, so the last logged value is never older than the stored one.
+	private ref map<int, int> m_mWriteAheadXP = new map<int, int>();
 
 	//------------------------------------------------------------------------------------------------
 	static PersistentXPManager GetInstance()
@@ -29,12 +54,47 @@ class PersistentXPManager
 		return s_Instance;
 	}
 	
+	//------------------------------------------------------------------------------------------------
+	//! Marks a player's XP as changed, so the next save writes it. Does nothing if the manager was never created.
+	static void NotifyXPChanged(int playerId)
+	{
+		if (s_Instance)
+			s_Instance.m_DirtyPlayerIDs.Insert(playerId);
+	}
+	
 	//------------------------------------------------------------------------------------------------
 	private void PersistentXPManager()
 	{
 		FileIO.MakeDirectory(XP_SAVE_PATH);
-		Print("Persistent XP Manager: Singleton instance created.", LogLevel.NORMAL);
-		GetGame().GetCallqueue().CallLater(SaveAllOnlinePlayersXP, PERIODIC_SAVE_INTERVAL_SECONDS * 1000, true);
+		
+		NarcoPersistentRankSettings settings = NarcoJsonSettingsManager.GetInstance().GetPersistentRankSettings();
+		m_Storage = NarcoXPStorage.Create(settings.m_sStorageBackend, XP_SAVE_PATH, settings.m_iWipeGeneration);
+		
+		float writeAheadInterval = settings.m_fWriteAheadIntervalSeconds;
+		if (writeAheadInterval <= 0)
+			writeAheadInterval = DEFAULT_WRITE_AHEAD_INTERVAL_SECONDS;
+		
+		ApplySaveSettings();
+		NarcoSettingsSnapshot.GetOnPublished().Insert(OnSettingsPublished);
+		
+		Print(string.Format("Persistent XP Manager: Singleton instance created (storage backend: %1).", m_Storage.Type()), LogLevel.NORMAL);
+		GetGame().GetCallqueue().CallLater(StartPeriodicSave, PERIODIC_SAVE_INTERVAL_SECONDS * 1000, true);
+		GetGame().GetCallqueue().CallLater(FlushWriteAheadLog, writeAheadInterval * 1000, true);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Reads the save batching settings, so the save queue doesn't look them up every frame.
+	private void ApplySaveSettings()
+	{
+		m_iSaveWritesPerFrame = NarcoJsonSettingsManager.GetInstance().GetPersistentRankSettings().m_iSaveWritesPerFrame;
+		if (m_iSaveWritesPerFrame <= 0)
+			m_iSaveWritesPerFrame = DEFAULT_SAVE_WRITES_PER_FRAME;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	private void OnSettingsPublished(NarcoSettingsSnapshot snapshot)
+	{
+		ApplySaveSettings();
 	}
 	
 	//------------------------------------------------------------------------------------------------
@@ -54,7 +114,7 @@ class PersistentXPManager
 			
 			if (settings.m_bLoadoutCleaning)
 			{
-				Print("Persistent XP Manager: LoadoutCleaner enabled. Running loadout wipe.", LogLevel.NORMAL);
+				Print("Persistent XP Manager: LoadoutCleaner enabled. Starting loadout wipe in the background.", LogLevel.NORMAL);
 				LoadoutCleaner.Run();
 			}
 			
@@ -68,19 +128,44 @@ class PersistentXPManager
 	}
 	
 	//------------------------------------------------------------------------------------------------
-	private void WipeAllXPData()
+	//! Loads all persisted XP into memory so spawn-time loads don't touch the disk. Call after CheckForXPWipe.
+	void PreloadXP()
 	{
-		array<string> filesToWipe = {};
-		FileIO.FindFiles(filesToWipe.Insert, XP_SAVE_PATH, ".json");
-		
-		int filesDeleted = 0;
-		foreach (string filePath : filesToWipe)
-		{
-			FileIO.DeleteFile(filePath);
-			filesDeleted++;
-		}
+		NarcoPersistentRankSettings settings = NarcoJsonSettingsManager.GetInstance().GetPersistentRankSettings();
+		m_Storage.Preload(settings.m_bIncrementalPreload, settings.m_iPreloadFilesPerFrame);
+		ReplayWriteAheadLog();
 		
-		Print(string.Format("Persistent XP Manager: XP Wipe complete. Deleted %1 player XP files.", filesDeleted), LogLevel.NORMAL);
+		// Records left behind by earlier wipes are removed once the server is up and running.
+		if (settings.m_iCollectedWipeGeneration < settings.m_iWipeGeneration)
+			GetGame().GetCallqueue().CallLater(CollectStaleRecords, STALE_COLLECTION_DELAY_SECONDS * 1000, false);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Called by the storage backend once all records of older wipe generations are gone.
+	void OnStaleRecordsCollected()
+	{
+		NarcoPersistentRankSettings settings = NarcoJsonSettingsManager.GetInstance().GetPersistentRankSettings();
+		settings.m_iCollectedWipeGeneration = settings.m_iWipeGeneration;
+		NarcoJsonSettingsManager.GetInstance().SaveSettings();
+		Print(string.Format("Persistent XP Manager: Stale XP data collected up to wipe generation %1.", settings.m_iWipeGeneration), LogLevel.NORMAL);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Wipes all XP by starting a new wipe generation. Nothing is deleted here, see CollectStaleRecords().
+	private void WipeAllXPData()
+	{
+		NarcoPersistentRankSettings settings = NarcoJsonSettingsManager.GetInstance().GetPersistentRankSettings();
+		settings.m_iWipeGeneration++;
+		m_Storage.SetGeneration(settings.m_iWipeGeneration);
+		m_mLastSavedXP.Clear();
+		Print(string.Format("Persistent XP Manager: XP Wipe complete. Now on wipe generation %1.", settings.m_iWipeGeneration), LogLevel.NORMAL);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	private void CollectStaleRecords()
+	{
+		Print("Persistent XP Manager: Collecting stale XP data from previous wipes in the background.", LogLevel.NORMAL);
+		m_Storage.CollectStaleRecords(STALE_COLLECTION_FILES_PER_FRAME);
 	}
 
 	//------------------------------------------------------------------------------------------------
@@ -89,69 +174,294 @@ class PersistentXPManager
 		string guid = GetPlayerGUID(playerId);
 		if (guid.IsEmpty()) return;
 
-		string filePath = GetPlayerSavePath(guid);
-		if (!FileIO.FileExists(filePath)) return;
-			
-		PersistentXPData data = new PersistentXPData();
-		SCR_JsonLoadContext loadContext = new SCR_JsonLoadContext();
-		if (!loadContext.LoadFromFile(filePath) || !loadContext.ReadValue("", data))
-		{
-			Print(string.Format("Persistent XP Manager ERROR: Failed to load or read XP file for GUID %1.", guid), LogLevel.ERROR);
-			return;
-		}
-			
-		PlayerController pc = GetGame().GetPlayerManager().GetPlayerController(playerId);
-		if (!pc) return;
+		int totalXP;
+		if (!m_Storage.Load(guid, totalXP)) return;
 		
-		SCR_PlayerXPHandlerComponent playerXPHandler = SCR_PlayerXPHandlerComponent.Cast(pc.FindComponent(SCR_PlayerXPHandlerComponent));
+		SCR_PlayerXPHandlerComponent playerXPHandler = GetPlayerXPHandler(playerId);
 		if (!playerXPHandler) return;
 		
-		playerXPHandler.AddPlayerXP(SCR_EXPRewards.UNDEFINED, 1, false, data.m_iTotalXP);
-		//Print(string.Format("Persistent XP Manager: Loaded %1 XP for player %2.", data.m_iTotalXP, GetGame().GetPlayerManager().GetPlayerName(playerId)), LogLevel.NORMAL);
+		playerXPHandler.AddPlayerXP(SCR_EXPRewards.UNDEFINED, 1, false, totalXP);
+		
+		// The XP just loaded is what is on disk, nothing to write back.
+		m_mLastSavedXP.Set(playerId, playerXPHandler.GetPlayerXP());
+		m_DirtyPlayerIDs.RemoveItem(playerId);
+		//Print(string.Format("Persistent XP Manager: Loaded %1 XP for player %2.", totalXP, GetGame().GetPlayerManager().GetPlayerName(playerId)), LogLevel.NORMAL);
 	}
 
 	//------------------------------------------------------------------------------------------------
+	//! Immediately writes a leaving player's XP if it changed, then forgets about them.
 	void SavePlayerXP(int playerId)
+	{
+		int queueIndex = FindQueuedSave(playerId);
+		if (m_DirtyPlayerIDs.Contains(playerId) || queueIndex >= 0)
+		{
+			LogWriteAhead({playerId});
+			WritePlayerXP(playerId);
+			m_Storage.Flush();
+		}
+		
+		// Removing at or after the index keeps the entries still to be written in place.
+		m_DirtyPlayerIDs.RemoveItem(playerId);
+		if (queueIndex >= 0)
+			m_aSaveQueue.RemoveOrdered(queueIndex);
+		m_mLastSavedXP.Remove(playerId);
+		m_mWriteAheadXP.Remove(playerId);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Synchronously writes every player whose XP changed since the last save (end of game).
+	void SaveAllOnlinePlayersXP()
+	{
+		QueueDirtyPlayers();
+		Print(string.Format("Persistent XP Manager: Saving XP for %1 changed players (end-of-game)...", GetPendingSaveCount()), LogLevel.NORMAL);
+		
+		array<int> pending = {};
+		CopyPendingSaves(pending);
+		LogWriteAhead(pending);
+		foreach (int id : pending)
+		{
+			WritePlayerXP(id);
+		}
+		
+		StopSaveQueue();
+		m_Storage.Flush();
+		ResetWriteAheadLog();
+		Print("Persistent XP Manager: Finished saving all online players.", LogLevel.NORMAL);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Periodic save. Queues the dirty players and writes them over the following frames.
+	private void StartPeriodicSave()
+	{
+		QueueDirtyPlayers();
+		if (GetPendingSaveCount() == 0)
+			return;
+		
+		Print(string.Format("Persistent XP Manager: Periodic save queued for %1 changed players.", GetPendingSaveCount()), LogLevel.NORMAL);
+		
+		if (!m_bSaveQueueRunning)
+		{
+			m_bSaveQueueRunning = true;
+			GetGame().GetCallqueue().CallLater(ProcessSaveQueue, 0, true);
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Moves all dirty players into the save queue.
+	private void QueueDirtyPlayers()
+	{
+		foreach (int id : m_DirtyPlayerIDs)
+		{
+			if (FindQueuedSave(id) < 0)
+				m_aSaveQueue.Insert(id);
+		}
+		
+		m_DirtyPlayerIDs.Clear();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Returns the position of a player in the part of the save queue not yet written, or -1.
+	private int FindQueuedSave(int playerId)
+	{
+		for (int i = m_aSaveQueue.Count() - 1; i >= m_iSaveQueueIndex; i--)
+		{
+			if (m_aSaveQueue[i] == playerId)
+				return i;
+		}
+		
+		return -1;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	private int GetPendingSaveCount()
+	{
+		return m_aSaveQueue.Count() - m_iSaveQueueIndex;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Appends the players still waiting in the save queue.
+	private void CopyPendingSaves(notnull array<int> playerIds)
+	{
+		for (int i = m_iSaveQueueIndex; i < m_aSaveQueue.Count(); i++)
+		{
+			playerIds.Insert(m_aSaveQueue[i]);
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Called every frame while the save queue is not empty. Writes at most the configured number of files.
+	private void ProcessSaveQueue()
+	{
+		int end = Math.Min(m_iSaveQueueIndex + m_iSaveWritesPerFrame, m_aSaveQueue.Count());
+		m_aSaveBatch.Clear();
+		for (; m_iSaveQueueIndex < end; m_iSaveQueueIndex++)
+		{
+			m_aSaveBatch.Insert(m_aSaveQueue[m_iSaveQueueIndex]);
+		}
+		
+		LogWriteAhead(m_aSaveBatch);
+		foreach (int id : m_aSaveBatch)
+		{
+			WritePlayerXP(id);
+		}
+		
+		if (GetPendingSaveCount() == 0)
+		{
+			StopSaveQueue();
+			m_Storage.Flush();
+			ResetWriteAheadLog();
+			Print("Persistent XP Manager: Periodic save finished.", LogLevel.NORMAL);
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	private void StopSaveQueue()
+	{
+		GetGame().GetCallqueue().Remove(ProcessSaveQueue);
+		m_bSaveQueueRunning = false;
+		m_aSaveQueue.Clear();
+		m_iSaveQueueIndex = 0;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Stores a single player's XP, unless the stored value is already current.
+	private void WritePlayerXP(int playerId)
 	{
 		string guid = GetPlayerGUID(playerId);
 		if (guid.IsEmpty()) return;
 		
-		PlayerController pc = GetGame().GetPlayerManager().GetPlayerController(playerId);
-		if (!pc) return;
-		
-		SCR_PlayerXPHandlerComponent playerXPHandler = SCR_PlayerXPHandlerComponent.Cast(pc.FindComponent(SCR_PlayerXPHandlerComponent));
+		SCR_PlayerXPHandlerComponent playerXPHandler = GetPlayerXPHandler(playerId);
 		if (!playerXPHandler) return;
 		
 		int totalXP = playerXPHandler.GetPlayerXP();
 		
-		PersistentXPData data = new PersistentXPData();
-		data.m_iTotalXP = totalXP;
-		
-		string filePath = GetPlayerSavePath(guid);
-		FileIO.MakeDirectory(XP_SAVE_PATH + guid.Substring(0, 2));
-
-		SCR_JsonSaveContext saveContext = new SCR_JsonSaveContext();
-		saveContext.WriteValue("", data);
+		int lastSavedXP;
+		if (m_mLastSavedXP.Find(playerId, lastSavedXP) && lastSavedXP == totalXP)
+			return;
 		
-		if (!saveContext.SaveToFile(filePath))
+		if (!m_Storage.Save(guid, totalXP))
+		{
 			Print(string.Format("Persistent XP Manager ERROR: Failed to save XP data for player %1.", GetGame().GetPlayerManager().GetPlayerName(playerId)), LogLevel.ERROR);
+			return;
+		}
+		
+		m_mLastSavedXP.Set(playerId, totalXP);
 	}
 	
 	//------------------------------------------------------------------------------------------------
-	void SaveAllOnlinePlayersXP()
+	//! Logs the XP of every changed, not yet stored player. Runs on a short interval between full saves.
+	private void FlushWriteAheadLog()
 	{
-		Print("Persistent XP Manager: Saving XP for all online players (periodic or end-of-game)...", LogLevel.NORMAL);
-		PlayerManager playerManager = GetGame().GetPlayerManager();
-		if (!playerManager) return;
-		
 		array<int> playerIds = {};
-		playerManager.GetPlayers(playerIds);
+		foreach (int id : m_DirtyPlayerIDs)
+		{
+			playerIds.Insert(id);
+		}
+		
+		CopyPendingSaves(playerIds);
+		LogWriteAhead(playerIds);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Appends the current XP of the given players to the write-ahead log with a single open. Values that are
+	//! already logged or stored are skipped.
+	private void LogWriteAhead(notnull array<int> playerIds)
+	{
+		int generation = NarcoJsonSettingsManager.GetInstance().GetPersistentRankSettings().m_iWipeGeneration;
+		array<string> records = {};
 		
 		foreach (int id : playerIds)
 		{
-			SavePlayerXP(id);
+			SCR_PlayerXPHandlerComponent playerXPHandler = GetPlayerXPHandler(id);
+			if (!playerXPHandler) continue;
+			
+			int totalXP = playerXPHandler.GetPlayerXP();
+			int knownXP;
+			if (m_mWriteAheadXP.Find(id, knownXP) && knownXP == totalXP)
+				continue;
+			
+			if (!m_mWriteAheadXP.Contains(id) && m_mLastSavedXP.Find(id, knownXP) && knownXP == totalXP)
+				continue;
+			
+			string guid = GetPlayerGUID(id);
+			if (guid.IsEmpty()) continue;
+			
+			records.Insert(guid + " " + totalXP.ToString() + " " + generation.ToString());
+			m_mWriteAheadXP.Set(id, totalXP);
 		}
-		Print("Persistent XP Manager: Finished saving all online players.", LogLevel.NORMAL);
+		
+		if (records.IsEmpty())
+			return;
+		
+		FileHandle log = FileIO.OpenFile(WRITE_AHEAD_LOG_PATH, FileMode.APPEND);
+		if (!log)
+		{
+			Print("Persistent XP Manager ERROR: Failed to open XP write-ahead log.", LogLevel.ERROR);
+			return;
+		}
+		
+		foreach (string record : records)
+		{
+			log.WriteLine(record);
+		}
+		
+		log.Close();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Starts a new write-ahead log once everything logged so far is stored. Players still changed are logged again right away.
+	private void ResetWriteAheadLog()
+	{
+		FileIO.DeleteFile(WRITE_AHEAD_LOG_PATH);
+		m_mWriteAheadXP.Clear();
+		FlushWriteAheadLog();
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Stores XP logged before a crash that never made it into storage. Later records of a player win,
+	//! records from an older wipe generation are dropped.
+	private void ReplayWriteAheadLog()
+	{
+		if (!FileIO.FileExists(WRITE_AHEAD_LOG_PATH))
+			return;
+		
+		FileHandle log = FileIO.OpenFile(WRITE_AHEAD_LOG_PATH, FileMode.READ);
+		if (!log)
+			return;
+		
+		int generation = NarcoJsonSettingsManager.GetInstance().GetPersistentRankSettings().m_iWipeGeneration;
+		map<string, int> recoveredXP = new map<string, int>();
+		string line;
+		array<string> fields = {};
+		while (log.ReadLine(line) >= 0)
+		{
+			fields.Clear();
+			line.Split(" ", fields, true);
+			if (fields.Count() != 3 || fields[2].ToInt() < generation)
+				continue;
+			
+			recoveredXP.Set(fields[0], fields[1].ToInt());
+		}
+		
+		log.Close();
+		
+		foreach (string guid, int totalXP : recoveredXP)
+		{
+			m_Storage.Save(guid, totalXP);
+		}
+		
+		m_Storage.Flush();
+		FileIO.DeleteFile(WRITE_AHEAD_LOG_PATH);
+		Print(string.Format("Persistent XP Manager: Recovered XP for %1 players from the write-ahead log.", recoveredXP.Count()), LogLevel.NORMAL);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	private SCR_PlayerXPHandlerComponent GetPlayerXPHandler(int playerId)
+	{
+		PlayerController pc = GetGame().GetPlayerManager().GetPlayerController(playerId);
+		if (!pc) return null;
+		
+		return SCR_PlayerXPHandlerComponent.Cast(pc.FindComponent(SCR_PlayerXPHandlerComponent));
 	}
 	
 	//------------------------------------------------------------------------------------------------
@@ -163,12 +473,6 @@ class PersistentXPManager
 		
 		return guid;
 	}
-	
-	//------------------------------------------------------------------------------------------------
-	private string GetPlayerSavePath(string guid)
-	{
-		return XP_SAVE_PATH + guid.Substring(0, 2) + "/" + guid + ".json";
-	}
 }
 
 
@@ -178,13 +482,26 @@ modded class SCR_FactionManager
 {
 	override int GetRequiredRankXP(SCR_ECharacterRank rankID)
 	{
-		NarcoJsonSettingsManager settingsManager = NarcoJsonSettingsManager.GetInstance();
-		if (!settingsManager || !settingsManager.GetPersistentRankSettings() || !settingsManager.GetPersistentRankSettings().m_bEnabled)
+		NarcoSettingsSnapshot settings = NarcoSettingsSnapshot.Get();
+		if (!settings.m_bPersistentRankEnabled)
 			return super.GetRequiredRankXP(rankID);
 		
-		int originalXP = super.GetRequiredRankXP(rankID);
-		float multiplier = settingsManager.GetPersistentRankSettings().m_fRankXPMultiplier;
-		return Math.Round(originalXP * multiplier);
+		return Math.Round(super.GetRequiredRankXP(rankID) * settings.m_fRankXPMultiplier);
+	}
+}
+
+
+//------------------------------------------------------------------------------------------------
+// --- XP Change Tracking ---
+modded class SCR_PlayerXPHandlerComponent
+{
+	override void AddPlayerXP(SCR_EXPRewards rewardID, float multiplier = 1.0, bool volunteer = false, int customXP = 0)
+	{
+		super.AddPlayerXP(rewardID, multiplier, volunteer, customXP);
+		
+		PlayerController pc = PlayerController.Cast(GetOwner());
+		if (pc)
+			PersistentXPManager.NotifyXPChanged(pc.GetPlayerId());
 	}
 }
 
@@ -202,14 +519,18 @@ modded class SCR_BaseGameMode
 
 		if (IsMaster())
 		{
-			// Get settings instance.
-			NarcoJsonSettingsManager.GetInstance();
+			// Get settings instance and pick up later edits of the config file.
+			NarcoJsonSettingsManager.GetInstance().WatchForChanges();
+			SCR_PlayerController.WatchForClientSettingsChanges();
+			LoadoutCleaner.WatchForBlocklistChanges();
 			
 			// If the persistent rank system is enabled, initialize it.
 			if (NarcoJsonSettingsManager.GetInstance().GetPersistentRankSettings().m_bEnabled)
 			{
 				m_PersistentXP_LoadedPlayerIDs = new set<int>();
 				PersistentXPManager.GetInstance().CheckForXPWipe();
+				PersistentXPManager.GetInstance().PreloadXP();
+				LoadoutCleaner.Resume();
 			}
 			else
 			{
@@ -0,0 +1,514 @@
+//------------------------------------------------------------------------------------------------
+// SCRIPT: Narco_XPStorage.c
+// PURPOSE: Storage backends for persistent XP, selectable in NarcoPersistentRankSettings.
+//------------------------------------------------------------------------------------------------
+
+// --- Base Backend ---
+// Every record is stamped with the wipe generation it was saved in. Records from an older generation
+// count as absent, so a wipe only has to bump the generation; the stale data is removed later by CollectStaleRecords().
+class NarcoXPStorage
+{
+	protected string m_sBasePath;
+	protected int m_iGeneration;
+
+	//------------------------------------------------------------------------------------------------
+	void NarcoXPStorage(string basePath, int generation)
+	{
+		m_sBasePath = basePath;
+		m_iGeneration = generation;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Creates the storage backend selected in the config. Unknown values fall back to JSON.
+	static NarcoXPStorage Create(string backend, string basePath, int generation)
+	{
+		if (backend == NarcoXPJournalStorage.BACKEND_NAME)
+			return new NarcoXPJournalStorage(basePath, generation);
+
+		return new NarcoXPJsonStorage(basePath, generation);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Reads all stored XP into memory, so later loads are lookups. Incremental preloads are spread over frames.
+	void Preload(bool incremental, int filesPerFrame)
+	{
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Returns true and the stored XP if the player has a record.
+	bool Load(string guid, out int totalXP)
+	{
+		return false;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Stores the player's XP. Backends may buffer it until Flush().
+	bool Save(string guid, int totalXP)
+	{
+		return false;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Writes out anything buffered by Save().
+	void Flush()
+	{
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Switches to a new wipe generation. Everything stored so far becomes stale. Must be called before Preload().
+	void SetGeneration(int generation)
+	{
+		m_iGeneration = generation;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Removes records of older generations from disk, spread over frames where possible. Calls FinishCollection() when done.
+	void CollectStaleRecords(int filesPerFrame)
+	{
+		FinishCollection();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	protected void FinishCollection()
+	{
+		PersistentXPManager.GetInstance().OnStaleRecordsCollected();
+	}
+}
+
+
+// --- JSON Backend (one file per player) ---
+class NarcoXPJsonStorage : NarcoXPStorage
+{
+	static const string BACKEND_NAME = "json";
+
+	// Files are written to a temp copy first, so a crash mid-write never leaves only a half-written record.
+	private const string TEMP_SUFFIX = ".tmp";
+
+	private ref set<string> m_CreatedDirectories = new set<string>();
+
+	// --- Preload cache ---
+	private ref map<string, int> m_mCache = new map<string, int>();
+	private ref array<string> m_aPreloadQueue = {};
+	private int m_iPreloadQueueIndex;
+	private int m_iPreloadFilesPerFrame;
+	private bool m_bPreloaded;
+
+	// --- Stale record collection ---
+	private bool m_bGenerationChanged;
+	private ref set<string> m_StaleGUIDs = new set<string>();
+	private ref array<string> m_aCollectQueue = {};
+	private int m_iCollectQueueIndex;
+	private int m_iCollectFilesPerFrame;
+	private bool m_bCollectAfterPreload;
+	private int m_iCollectedFiles;
+
+	//------------------------------------------------------------------------------------------------
+	override void Preload(bool incremental, int filesPerFrame)
+	{
+		m_aPreloadQueue.Clear();
+		m_iPreloadQueueIndex = 0;
+
+		// Right after a wipe nothing on disk is current, so there is nothing to read.
+		if (m_bGenerationChanged)
+		{
+			FinishPreload();
+			return;
+		}
+
+		FileIO.FindFiles(m_aPreloadQueue.Insert, m_sBasePath, ".json");
+		Print(string.Format("Persistent XP Manager: Preloading %1 player XP files...", m_aPreloadQueue.Count()), LogLevel.NORMAL);
+
+		if (!incremental)
+		{
+			foreach (string filePath : m_aPreloadQueue)
+			{
+				PreloadFile(filePath);
+			}
+
+			FinishPreload();
+			return;
+		}
+
+		m_iPreloadFilesPerFrame = Math.Max(filesPerFrame, 1);
+		GetGame().GetCallqueue().CallLater(ProcessPreloadQueue, 0, true);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override bool Load(string guid, out int totalXP)
+	{
+		if (m_mCache.Find(guid, totalXP))
+			return true;
+
+		// Once everything is in memory, a cache miss means the player has no record.
+		if (m_bPreloaded)
+			return false;
+
+		// Still preloading (or preload disabled), go to disk for this player.
+		int generation;
+		if (!ReadFile(GetPlayerSavePath(guid), totalXP, generation) || generation < m_iGeneration)
+			return false;
+
+		m_mCache.Set(guid, totalXP);
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override bool Save(string guid, int totalXP)
+	{
+		PersistentXPData data = new PersistentXPData();
+		data.m_iTotalXP = totalXP;
+		data.m_iWipeGeneration = m_iGeneration;
+
+		string directory = m_sBasePath + guid.Substring(0, 2);
+		if (!m_CreatedDirectories.Contains(directory))
+		{
+			FileIO.MakeDirectory(directory);
+			m_CreatedDirectories.Insert(directory);
+		}
+
+		string filePath = GetPlayerSavePath(guid);
+		string tempPath = filePath + TEMP_SUFFIX;
+
+		SCR_JsonSaveContext saveContext = new SCR_JsonSaveContext();
+		saveContext.WriteValue("", data);
+		if (!saveContext.SaveToFile(tempPath) || !FileIO.CopyFile(tempPath, filePath))
+			return false;
+
+		FileIO.DeleteFile(tempPath);
+
+		m_mCache.Set(guid, totalXP);
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override void SetGeneration(int generation)
+	{
+		if (generation == m_iGeneration)
+			return;
+
+		super.SetGeneration(generation);
+		m_bGenerationChanged = true;
+		m_mCache.Clear();
+		m_aPreloadQueue.Clear();
+		m_iPreloadQueueIndex = 0;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Deletes the files of stale records without reading them. Relies on the preload to tell which files are current,
+	//! so it waits for the preload to finish first.
+	override void CollectStaleRecords(int filesPerFrame)
+	{
+		m_iCollectFilesPerFrame = Math.Max(filesPerFrame, 1);
+
+		if (!m_bPreloaded)
+		{
+			m_bCollectAfterPreload = true;
+			return;
+		}
+
+		m_aCollectQueue.Clear();
+		m_iCollectQueueIndex = 0;
+		FileIO.FindFiles(m_aCollectQueue.Insert, m_sBasePath, ".json");
+		m_iCollectedFiles = 0;
+		GetGame().GetCallqueue().CallLater(ProcessCollectQueue, 0, true);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Called every frame while stale files are being deleted.
+	private void ProcessCollectQueue()
+	{
+		int end = Math.Min(m_iCollectQueueIndex + m_iCollectFilesPerFrame, m_aCollectQueue.Count());
+		for (; m_iCollectQueueIndex < end; m_iCollectQueueIndex++)
+		{
+			string filePath = m_aCollectQueue[m_iCollectQueueIndex];
+			string guid = FilePath.StripExtension(FilePath.StripPath(filePath));
+
+			// Cached records are current (loaded or saved this generation). Unreadable files are left alone.
+			if (m_mCache.Contains(guid))
+				continue;
+
+			if (m_bGenerationChanged || m_StaleGUIDs.Contains(guid))
+			{
+				FileIO.DeleteFile(filePath);
+				m_iCollectedFiles++;
+			}
+		}
+
+		if (m_iCollectQueueIndex < m_aCollectQueue.Count())
+			return;
+
+		GetGame().GetCallqueue().Remove(ProcessCollectQueue);
+		m_aCollectQueue.Clear();
+		m_iCollectQueueIndex = 0;
+		m_StaleGUIDs.Clear();
+		Print(string.Format("Persistent XP Manager: Deleted %1 stale player XP files.", m_iCollectedFiles), LogLevel.NORMAL);
+		FinishCollection();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Called every frame during an incremental preload.
+	private void ProcessPreloadQueue()
+	{
+		// Walk the queue with an index; removing each batch from the front would shift the whole array every frame.
+		int end = Math.Min(m_iPreloadQueueIndex + m_iPreloadFilesPerFrame, m_aPreloadQueue.Count());
+		for (; m_iPreloadQueueIndex < end; m_iPreloadQueueIndex++)
+		{
+			PreloadFile(m_aPreloadQueue[m_iPreloadQueueIndex]);
+		}
+
+		if (m_iPreloadQueueIndex >= m_aPreloadQueue.Count())
+		{
+			GetGame().GetCallqueue().Remove(ProcessPreloadQueue);
+			FinishPreload();
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private void PreloadFile(string filePath)
+	{
+		string guid = FilePath.StripExtension(FilePath.StripPath(filePath));
+
+		// Records saved (and cached) during an incremental preload are newer than the file we would read.
+		if (m_mCache.Contains(guid))
+			return;
+
+		int totalXP;
+		int generation;
+		if (!ReadFile(filePath, totalXP, generation))
+			return;
+
+		if (generation < m_iGeneration)
+			m_StaleGUIDs.Insert(guid);
+		else
+			m_mCache.Set(guid, totalXP);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private void FinishPreload()
+	{
+		m_aPreloadQueue.Clear();
+		m_iPreloadQueueIndex = 0;
+		m_bPreloaded = true;
+		Print(string.Format("Persistent XP Manager: Preloaded XP for %1 players.", m_mCache.Count()), LogLevel.NORMAL);
+
+		if (m_bCollectAfterPreload)
+		{
+			m_bCollectAfterPreload = false;
+			CollectStaleRecords(m_iCollectFilesPerFrame);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Reads a player file. If it is damaged, falls back to the temp copy left behind by an interrupted save.
+	private bool ReadFile(string filePath, out int totalXP, out int generation)
+	{
+		PersistentXPData data = new PersistentXPData();
+		if (!ReadData(filePath, data) && !ReadData(filePath + TEMP_SUFFIX, data))
+		{
+			if (FileIO.FileExists(filePath))
+				Print(string.Format("Persistent XP Manager ERROR: Failed to load or read XP file %1.", filePath), LogLevel.ERROR);
+
+			return false;
+		}
+
+		totalXP = data.m_iTotalXP;
+		generation = data.m_iWipeGeneration;
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private bool ReadData(string filePath, PersistentXPData data)
+	{
+		if (!FileIO.FileExists(filePath))
+			return false;
+
+		SCR_JsonLoadContext loadContext = new SCR_JsonLoadContext();
+		return loadContext.LoadFromFile(filePath) && loadContext.ReadValue("", data);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private string GetPlayerSavePath(string guid)
+	{
+		return m_sBasePath + guid.Substring(0, 2) + "/" + guid + ".json";
+	}
+}
+
+
+// --- Journal Backend (append-only GUID -> XP log with periodic compaction) ---
+// Records are "<guid> <xp> <generation>" lines. The snapshot holds one record per player, the journal holds every
+// save since the last compaction; later records win. Both are read once into an in-memory index by Preload().
+class NarcoXPJournalStorage : NarcoXPStorage
+{
+	static const string BACKEND_NAME = "journal";
+
+	private const string SNAPSHOT_FILE = "xp_snapshot.txt";
+	private const string JOURNAL_FILE = "xp_journal.txt";
+	private const int DEFAULT_COMPACTION_THRESHOLD = 10000;
+
+	private ref map<string, int> m_mIndex = new map<string, int>();
+	private ref array<string> m_aPendingRecords = {};
+	private int m_iJournalRecords;
+	private bool m_bHasStaleRecords;
+
+	//------------------------------------------------------------------------------------------------
+	//! The journal is always read in one go, it is a single sequential file.
+	override void Preload(bool incremental, int filesPerFrame)
+	{
+		// Right after a wipe every stored record is stale, so there is nothing to read.
+		if (m_bHasStaleRecords)
+			return;
+
+		ReadRecords(m_sBasePath + SNAPSHOT_FILE);
+		m_iJournalRecords = ReadRecords(m_sBasePath + JOURNAL_FILE);
+
+		Print(string.Format("Persistent XP Manager: Journal storage indexed %1 players (%2 journal records).", m_mIndex.Count(), m_iJournalRecords), LogLevel.NORMAL);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override bool Load(string guid, out int totalXP)
+	{
+		return m_mIndex.Find(guid, totalXP);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override bool Save(string guid, int totalXP)
+	{
+		m_mIndex.Set(guid, totalXP);
+		m_aPendingRecords.Insert(FormatRecord(guid, totalXP));
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Appends all buffered records to the journal with a single open, compacting once it grows too large.
+	override void Flush()
+	{
+		if (m_aPendingRecords.IsEmpty())
+			return;
+
+		FileHandle journal = FileIO.OpenFile(m_sBasePath + JOURNAL_FILE, FileMode.APPEND);
+		if (!journal)
+		{
+			Print("Persistent XP Manager ERROR: Failed to open XP journal for writing.", LogLevel.ERROR);
+			return;
+		}
+
+		foreach (string record : m_aPendingRecords)
+		{
+			journal.WriteLine(record);
+		}
+
+		journal.Close();
+		m_iJournalRecords += m_aPendingRecords.Count();
+		m_aPendingRecords.Clear();
+
+		int threshold = NarcoJsonSettingsManager.GetInstance().GetPersistentRankSettings().m_iJournalCompactionThreshold;
+		if (threshold <= 0)
+			threshold = DEFAULT_COMPACTION_THRESHOLD;
+
+		if (m_iJournalRecords >= threshold)
+			Compact();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	override void SetGeneration(int generation)
+	{
+		if (generation == m_iGeneration)
+			return;
+
+		super.SetGeneration(generation);
+		m_mIndex.Clear();
+		m_aPendingRecords.Clear();
+		m_bHasStaleRecords = true;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! The index only ever holds current records, so compacting it drops everything stale.
+	override void CollectStaleRecords(int filesPerFrame)
+	{
+		if (m_bHasStaleRecords)
+			Compact();
+
+		FinishCollection();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Rewrites the in-memory index as the new snapshot and starts an empty journal.
+	private void Compact()
+	{
+		string snapshotPath = m_sBasePath + SNAPSHOT_FILE;
+		string tempPath = snapshotPath + ".tmp";
+
+		FileHandle snapshot = FileIO.OpenFile(tempPath, FileMode.WRITE);
+		if (!snapshot)
+		{
+			Print("Persistent XP Manager ERROR: Failed to open XP snapshot for compaction.", LogLevel.ERROR);
+			return;
+		}
+
+		foreach (string guid, int totalXP : m_mIndex)
+		{
+			snapshot.WriteLine(FormatRecord(guid, totalXP));
+		}
+
+		snapshot.Close();
+
+		if (!FileIO.CopyFile(tempPath, snapshotPath))
+		{
+			Print("Persistent XP Manager ERROR: Failed to replace XP snapshot during compaction.", LogLevel.ERROR);
+			return;
+		}
+
+		FileIO.DeleteFile(tempPath);
+		FileIO.DeleteFile(m_sBasePath + JOURNAL_FILE);
+		Print(string.Format("Persistent XP Manager: Compacted XP journal (%1 records) into a snapshot of %2 players.", m_iJournalRecords, m_mIndex.Count()), LogLevel.NORMAL);
+		m_iJournalRecords = 0;
+		m_bHasStaleRecords = false;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private string FormatRecord(string guid, int totalXP)
+	{
+		return guid + " " + totalXP.ToString() + " " + m_iGeneration.ToString();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Reads records into the index, skipping those of older generations. Records without a generation
+	//! predate the field and belong to generation 0. Returns the number of valid records.
+	private int ReadRecords(string filePath)
+	{
+		if (!FileIO.FileExists(filePath))
+			return 0;
+
+		FileHandle file = FileIO.OpenFile(filePath, FileMode.READ);
+		if (!file)
+			return 0;
+
+		int records = 0;
+		string line;
+		array<string> fields = {};
+		while (file.ReadLine(line) >= 0)
+		{
+			fields.Clear();
+			line.Split(" ", fields, true);
+			if (fields.Count() != 2 && fields.Count() != 3)
+				continue;
+
+			records++;
+
+			int generation = 0;
+			if (fields.Count() == 3)
+				generation = fields[2].ToInt();
+
+			if (generation < m_iGeneration)
+			{
+				m_bHasStaleRecords = true;
+				continue;
+			}
+
+			m_mIndex.Set(fields[0], fields[1].ToInt());
+		}
+
+		file.Close();
+		return records;
+	}
+}
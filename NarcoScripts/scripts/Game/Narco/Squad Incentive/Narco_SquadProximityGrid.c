@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------------------------
+// SCRIPT: Narco_SquadProximityGrid.c
+// PURPOSE: Uniform spatial hash grid used by the Squad Incentive system for squadmate proximity queries.
+//------------------------------------------------------------------------------------------------
+
+class NarcoSquadProximityGrid
+{
+	// Cell coordinates are packed into a single int key, 16 bits per axis.
+	private const int CELL_AXIS_MASK = 0xFFFF;
+
+	private float m_fCellSize = 1;
+	private float m_fRadiusSq;
+
+	// --- Per-entry data (parallel arrays, rebuilt every tick) ---
+	private ref array<int> m_aPlayerIDs = {};
+	private ref array<int> m_aSquadIDs = {};
+	private ref array<vector> m_aPositions = {};
+	private ref map<int, int> m_mEntryByPlayerID = new map<int, int>();
+
+	// --- Cells (kept allocated between rebuilds, only cleared) ---
+	private ref map<int, ref array<int>> m_mCells = new map<int, ref array<int>>();
+	private ref array<int> m_aOccupiedCellKeys = {};
+
+	//------------------------------------------------------------------------------------------------
+	//! Sets the proximity radius. The cell size matches it, so a query only ever needs the 3x3 neighbourhood.
+	void SetRadius(float radius)
+	{
+		m_fCellSize = Math.Max(radius, 1);
+		m_fRadiusSq = radius * radius;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Empties the grid without releasing the cell arrays.
+	void Clear()
+	{
+		foreach (int key : m_aOccupiedCellKeys)
+		{
+			m_mCells.Get(key).Clear();
+		}
+
+		m_aOccupiedCellKeys.Clear();
+		m_aPlayerIDs.Clear();
+		m_aSquadIDs.Clear();
+		m_aPositions.Clear();
+		m_mEntryByPlayerID.Clear();
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Adds a living squad member at the given world position.
+	void Insert(int playerID, int squadID, vector position)
+	{
+		int entry = m_aPlayerIDs.Insert(playerID);
+		m_aSquadIDs.Insert(squadID);
+		m_aPositions.Insert(position);
+		m_mEntryByPlayerID.Set(playerID, entry);
+
+		int key = GetCellKey(GetCellCoord(position[0]), GetCellCoord(position[2]));
+		array<int> cell = m_mCells.Get(key);
+		if (!cell)
+		{
+			cell = {};
+			m_mCells.Insert(key, cell);
+		}
+
+		if (cell.IsEmpty())
+			m_aOccupiedCellKeys.Insert(key);
+
+		cell.Insert(entry);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	//! Returns the number of squadmates within the radius of the given player. Players not in the grid have none.
+	int CountNearbySquadmates(int playerID)
+	{
+		int entry;
+		if (!m_mEntryByPlayerID.Find(playerID, entry))
+			return 0;
+
+		int squadID = m_aSquadIDs[entry];
+		vector position = m_aPositions[entry];
+		int cellX = GetCellCoord(position[0]);
+		int cellZ = GetCellCoord(position[2]);
+
+		int nearbyMembers = 0;
+		for (int x = cellX - 1; x <= cellX + 1; x++)
+		{
+			for (int z = cellZ - 1; z <= cellZ + 1; z++)
+			{
+				array<int> cell = m_mCells.Get(GetCellKey(x, z));
+				if (!cell)
+					continue;
+
+				foreach (int other : cell)
+				{
+					if (other == entry || m_aSquadIDs[other] != squadID)
+						continue;
+
+					if (vector.DistanceSq(position, m_aPositions[other]) <= m_fRadiusSq)
+						nearbyMembers++;
+				}
+			}
+		}
+
+		return nearbyMembers;
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private int GetCellCoord(float worldCoord)
+	{
+		return Math.Floor(worldCoord / m_fCellSize);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	private int GetCellKey(int cellX, int cellZ)
+	{
+		return ((cellX & CELL_AXIS_MASK) << 16) | (cellZ & CELL_AXIS_MASK);
+	}
+}
@@ -3,22 +3,100 @@
 // PURPOSE: Modifies the base XP handler to add a squad-based XP incentive system.
 //------------------------------------------------------------------------------------------------
 
+// --- Data Class ---
+//! Cached per-player state for the squad incentive system.
+//! Rebuilt on spawn, marked dead on death, released on disconnect.
+class NarcoSquadPlayerState
+{
+	IEntity m_Entity;
+	CharacterControllerComponent m_Controller;
+	SCR_CampaignFaction m_Faction;
+	vector m_vMainBaseOrigin;
+	float m_fExclusionRadiusSq;
+	bool m_bHasMainBase;
+	bool m_bAlive;
+}
+
+//! Member roster and proximity timer block of one squad, maintained from SCR_AIGroup events.
+//! Member IDs and timers are parallel arrays; removals swap with the last element in both.
+class NarcoSquadRoster
+{
+	int m_iSquadID;
+	int m_iLeaderID = -1;
+	ref array<int> m_aMemberIDs = {};
+	ref array<float> m_aProximityTimers = {};
+
+	//------------------------------------------------------------------------------------------------
+	void AddMember(int playerID)
+	{
+		if (m_aMemberIDs.Contains(playerID))
+			return;
+
+		m_aMemberIDs.Insert(playerID);
+		m_aProximityTimers.Insert(0);
+	}
+
+	//------------------------------------------------------------------------------------------------
+	void RemoveMember(int playerID)
+	{
+		int index = m_aMemberIDs.Find(playerID);
+		if (index < 0)
+			return;
+
+		m_aMemberIDs.Remove(index);
+		m_aProximityTimers.Remove(index);
+	}
+}
+
+//------------------------------------------------------------------------------------------------
 modded class SCR_XPHandlerComponent
 {
 	// --- MEMBER VARIABLES (Loaded from JSON) ---
     private int m_iProximityDistance_Config;
     private float m_fXpInterval_Config;
+    private float m_fEvaluationRate_Config;
+    private int m_iEvaluationSlices_Config;
+    private float m_fSquadCohesionCap_Config;
+    private float m_fSquadLeadingCap_Config;
+    private int m_iMaxSquadMembersForBonus_Config;
     
 	// --- CONSTANTS ---
-    private const float MAX_SQUAD_MEMBERS_FOR_BONUS = 7.0;
-    private const float SQUAD_COHESION_CAP = 30;
-    private const float SQUAD_LEADING_CAP = 50;
+    private const int DEFAULT_MAX_SQUAD_MEMBERS_FOR_BONUS = 7;
+    private const float DEFAULT_SQUAD_COHESION_CAP = 30;
+    private const float DEFAULT_SQUAD_LEADING_CAP = 50;
+    private const float DEFAULT_EVALUATION_RATE = 4;
+    private const float MAIN_BASE_EXCLUSION_PADDING = 100;
 
 	// --- MEMBER VARIABLES ---
-    private ref map<int, float> m_mPlayerProximityTimers = new map<int, float>();
+	private ref NarcoSquadProximityGrid m_ProximityGrid = new NarcoSquadProximityGrid();
+	
+	// Squad XP multipliers, one row per reward type, indexed by nearby-member count within a row.
+	// A multiplier of 0 means the reward is not configured and nothing is awarded.
+	private ref array<SCR_EXPRewards> m_aSquadRewardTypes = { SCR_EXPRewards.SQUAD_LEADER_PROXIMITY, SCR_EXPRewards.SQUAD_LEADING };
+	private ref array<float> m_aSquadXPMultipliers = {};
+	private int m_iSquadXPMultiplierRowSize;
+	
+	// Rosters keyed by group ID. Only squads with at least one member have an entry.
+	private ref map<int, ref NarcoSquadRoster> m_mSquadRosters = new map<int, ref NarcoSquadRoster>();
+	private ref map<int, int> m_mPlayerSquadIDs = new map<int, int>();
+	
+	// Dense table indexed by player ID. A null slot means the state must be rebuilt on next use.
+	private ref array<ref NarcoSquadPlayerState> m_aPlayerStates = {};
+	
+	// --- Per-tick buffers (reused to avoid per-tick allocations) ---
+	private ref array<int> m_aTickPlayerIDs = {};
+	private ref array<NarcoSquadPlayerState> m_aTickPlayerStates = {};
+	private ref array<NarcoSquadRoster> m_aTickRosters = {};
+	
+	// --- Tick scheduling ---
+	private ref array<float> m_aSliceElapsedTime = {};
+	private int m_iCurrentSlice;
+	private WorldTimestamp m_LastTickTimestamp;
+	
 	private bool m_bIsMaster;
 	private bool m_bSquadXpEnabled;
 	private SCR_GroupsManagerComponent m_GroupsManager;
+	private SCR_CampaignFactionManager m_CampaignFactionManager;
 	
 	//------------------------------------------------------------------------------------------------
     override void OnPostInit(IEntity owner)
@@ -32,8 +110,14 @@ modded class SCR_XPHandlerComponent
 	{
 		super.EOnInit(owner);
 		m_bIsMaster = GetGameMode() && GetGameMode().IsMaster();
-        if (m_bIsMaster)
-        	SetEventMask(owner, EntityEvent.FRAME);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	override void OnDelete(IEntity owner)
+	{
+		StopSquadXP();
+		NarcoSettingsSnapshot.GetOnPublished().Remove(OnSettingsPublished);
+		super.OnDelete(owner);
 	}
 	
 	//------------------------------------------------------------------------------------------------
@@ -42,11 +126,8 @@ modded class SCR_XPHandlerComponent
 		super.OnGameModeStart();
 		if (m_bIsMaster)
 		{
-			// Load settings from the unified config file.
-			NarcoSquadXPSettings settings = NarcoJsonSettingsManager.GetInstance().GetSquadXPSettings();
-			m_bSquadXpEnabled = settings.m_bEnabled;
-			m_iProximityDistance_Config = settings.m_iProximityDistance;
-			m_fXpInterval_Config = settings.m_fXpInterval;
+			LoadSquadXPSettings();
+			NarcoSettingsSnapshot.GetOnPublished().Insert(OnSettingsPublished);
 			
 			if (!m_bSquadXpEnabled)
 			{
@@ -54,214 +135,529 @@ modded class SCR_XPHandlerComponent
 				return;
 			}
 			
-			Print("Squad Incentive Mod: Initialized on Server.", LogLevel.NORMAL);
-			
-			m_GroupsManager = SCR_GroupsManagerComponent.GetInstance();
-			if (!m_GroupsManager)
+			StartSquadXP();
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Reads the squad XP section of the unified config file into the member variables.
+	private void LoadSquadXPSettings()
+	{
+		NarcoSquadXPSettings settings = NarcoJsonSettingsManager.GetInstance().GetSquadXPSettings();
+		m_bSquadXpEnabled = settings.m_bEnabled;
+		m_iProximityDistance_Config = settings.m_iProximityDistance;
+		m_fXpInterval_Config = settings.m_fXpInterval;
+		m_fEvaluationRate_Config = settings.m_fEvaluationRate;
+		m_iEvaluationSlices_Config = settings.m_iEvaluationSlices;
+		m_ProximityGrid.SetRadius(m_iProximityDistance_Config);
+		
+		// Older config files do not have the scheduler fields yet.
+		if (m_fEvaluationRate_Config <= 0)
+			m_fEvaluationRate_Config = DEFAULT_EVALUATION_RATE;
+		
+		m_iEvaluationSlices_Config = Math.Max(m_iEvaluationSlices_Config, 1);
+		
+		m_fSquadCohesionCap_Config = settings.m_fSquadCohesionCap;
+		m_fSquadLeadingCap_Config = settings.m_fSquadLeadingCap;
+		m_iMaxSquadMembersForBonus_Config = settings.m_iMaxSquadMembersForBonus;
+		
+		if (m_iMaxSquadMembersForBonus_Config <= 0)
+		{
+			m_fSquadCohesionCap_Config = DEFAULT_SQUAD_COHESION_CAP;
+			m_fSquadLeadingCap_Config = DEFAULT_SQUAD_LEADING_CAP;
+			m_iMaxSquadMembersForBonus_Config = DEFAULT_MAX_SQUAD_MEMBERS_FOR_BONUS;
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Builds the payout table, starts the evaluation tick and subscribes to squad membership events.
+	private bool StartSquadXP()
+	{
+		Print("Squad Incentive Mod: Initialized on Server.", LogLevel.NORMAL);
+		
+		m_GroupsManager = SCR_GroupsManagerComponent.GetInstance();
+		if (!m_GroupsManager)
+		{
+			Print("Squad Incentive Mod: CRITICAL ERROR - Could not get SCR_GroupsManagerComponent instance on start!", LogLevel.ERROR);
+			return false;
+		}
+		
+		m_CampaignFactionManager = SCR_CampaignFactionManager.Cast(GetGame().GetFactionManager());
+		if (m_CampaignFactionManager)
+			Print("Squad Incentive Mod: Campaign game mode detected. Main base XP blocking enabled.", LogLevel.NORMAL);
+		else
+			Print("Squad Incentive Mod: Standard game mode detected. Main base XP blocking disabled.", LogLevel.NORMAL);
+		
+		BuildSquadXPMultiplierTable();
+		if (NarcoJsonSettingsManager.GetInstance().GetSquadXPSettings().m_bLogPayoutSchedule)
+			PrintPayoutSchedule();
+		
+		ResetEvaluationSlices();
+		GetGame().GetCallqueue().CallLater(EvaluateSquadXP, GetEvaluationDelayMs(), true);
+		
+		SCR_AIGroup.GetOnPlayerAdded().Insert(OnPlayerAddedToSquad);
+		SCR_AIGroup.GetOnPlayerRemoved().Insert(OnPlayerRemovedFromSquad);
+		SCR_AIGroup.GetOnPlayerLeaderChanged().Insert(OnSquadLeaderChanged);
+		return true;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Returns the time between evaluation ticks. Never 0, so a very high rate can't make the tick run every frame without delay.
+	private int GetEvaluationDelayMs()
+	{
+		return Math.Max(Math.Round(1000 / m_fEvaluationRate_Config), 1);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Stops the evaluation tick and the squad membership subscriptions. Rosters are left as they are.
+	private void StopSquadXP()
+	{
+		GetGame().GetCallqueue().Remove(EvaluateSquadXP);
+		SCR_AIGroup.GetOnPlayerAdded().Remove(OnPlayerAddedToSquad);
+		SCR_AIGroup.GetOnPlayerRemoved().Remove(OnPlayerRemovedFromSquad);
+		SCR_AIGroup.GetOnPlayerLeaderChanged().Remove(OnSquadLeaderChanged);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Called after the config file was reloaded. Applies the new squad XP section without a restart.
+	private void OnSettingsPublished(NarcoSettingsSnapshot snapshot)
+	{
+		bool wasEnabled = m_bSquadXpEnabled;
+		float previousRate = m_fEvaluationRate_Config;
+		int previousSlices = m_iEvaluationSlices_Config;
+		LoadSquadXPSettings();
+		
+		if (!m_bSquadXpEnabled)
+		{
+			if (wasEnabled)
 			{
-				Print("Squad Incentive Mod: CRITICAL ERROR - Could not get SCR_GroupsManagerComponent instance on start!", LogLevel.ERROR);
-				return;
+				StopSquadXP();
+				Print("Squad Incentive Mod: Disabled by config reload.", LogLevel.NORMAL);
 			}
 			
-			SCR_CampaignFactionManager campaignFactionManager = SCR_CampaignFactionManager.Cast(GetGame().GetFactionManager());
-			if (campaignFactionManager)
-				Print("Squad Incentive Mod: Campaign game mode detected. Main base XP blocking enabled.", LogLevel.NORMAL);
-			else
-				Print("Squad Incentive Mod: Standard game mode detected. Main base XP blocking disabled.", LogLevel.NORMAL);
+			return;
+		}
+		
+		// Membership events were missed while disabled, so the rosters are rebuilt from the live groups.
+		if (!wasEnabled)
+		{
+			if (StartSquadXP())
+				RebuildSquadRosters();
+			
+			return;
+		}
+		
+		BuildSquadXPMultiplierTable();
+		if (NarcoJsonSettingsManager.GetInstance().GetSquadXPSettings().m_bLogPayoutSchedule)
+			PrintPayoutSchedule();
+		
+		if (m_iEvaluationSlices_Config != previousSlices)
+			ResetEvaluationSlices();
+		
+		if (m_fEvaluationRate_Config != previousRate)
+		{
+			GetGame().GetCallqueue().Remove(EvaluateSquadXP);
+			GetGame().GetCallqueue().CallLater(EvaluateSquadXP, GetEvaluationDelayMs(), true);
+		}
+		
+		Print("Squad Incentive Mod: Applied reloaded settings.", LogLevel.NORMAL);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	private void ResetEvaluationSlices()
+	{
+		m_aSliceElapsedTime.Clear();
+		for (int i = 0; i < m_iEvaluationSlices_Config; i++)
+		{
+			m_aSliceElapsedTime.Insert(0);
+		}
+		
+		m_iCurrentSlice = 0;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Rebuilds every roster from the current playable groups.
+	private void RebuildSquadRosters()
+	{
+		m_mSquadRosters.Clear();
+		m_mPlayerSquadIDs.Clear();
+		
+		array<SCR_AIGroup> groups = {};
+		m_GroupsManager.GetAllPlayableGroups(groups);
+		foreach (SCR_AIGroup group : groups)
+		{
+			foreach (int playerID : group.GetPlayerIDs())
+			{
+				OnPlayerAddedToSquad(group, playerID);
+			}
+		}
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	override void OnPlayerSpawnFinalize_S(SCR_SpawnRequestComponent requestComponent, SCR_SpawnHandlerComponent handlerComponent, SCR_SpawnData data, IEntity entity)
+	{
+		super.OnPlayerSpawnFinalize_S(requestComponent, handlerComponent, data, entity);
+		
+		// A new entity, and possibly a new faction, so the whole record is stale.
+		if (m_bIsMaster)
+			InvalidatePlayerState(requestComponent.GetPlayerId());
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	override void OnPlayerKilled(notnull SCR_InstigatorContextData instigatorContextData)
+	{
+		super.OnPlayerKilled(instigatorContextData);
+		
+		if (!m_bIsMaster)
+			return;
+		
+		int playerID = instigatorContextData.GetVictimPlayerID();
+		if (playerID >= 0 && playerID < m_aPlayerStates.Count() && m_aPlayerStates[playerID])
+			m_aPlayerStates[playerID].m_bAlive = false;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	override void OnPlayerDisconnected(int playerId, KickCauseCode cause, int timeout)
+	{
+		super.OnPlayerDisconnected(playerId, cause, timeout);
+		
+		if (!m_bIsMaster)
+			return;
+		
+		// Release everything held for the player right away.
+		InvalidatePlayerState(playerId);
+		
+		int squadID;
+		if (m_mPlayerSquadIDs.Find(playerId, squadID))
+			RemoveFromRoster(squadID, playerId);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Called by SCR_AIGroup whenever a player joins any group.
+	private void OnPlayerAddedToSquad(SCR_AIGroup group, int playerID)
+	{
+		if (!group)
+			return;
+		
+		// Joining a new squad implicitly leaves the previous one.
+		int previousSquadID;
+		if (m_mPlayerSquadIDs.Find(playerID, previousSquadID))
+			RemoveFromRoster(previousSquadID, playerID);
+		
+		int squadID = group.GetGroupID();
+		NarcoSquadRoster roster = m_mSquadRosters.Get(squadID);
+		if (!roster)
+		{
+			roster = new NarcoSquadRoster();
+			roster.m_iSquadID = squadID;
+			roster.m_iLeaderID = group.GetLeaderID();
+			m_mSquadRosters.Insert(squadID, roster);
 		}
+		
+		roster.AddMember(playerID);
+		m_mPlayerSquadIDs.Set(playerID, squadID);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Called by SCR_AIGroup whenever a player leaves any group.
+	private void OnPlayerRemovedFromSquad(SCR_AIGroup group, int playerID)
+	{
+		if (group)
+			RemoveFromRoster(group.GetGroupID(), playerID);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Called by SCR_AIGroup whenever a group gets a new leader.
+	private void OnSquadLeaderChanged(int groupID, int playerID)
+	{
+		NarcoSquadRoster roster = m_mSquadRosters.Get(groupID);
+		if (roster)
+			roster.m_iLeaderID = playerID;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Removes a player from a roster, dropping the roster once it is empty.
+	private void RemoveFromRoster(int squadID, int playerID)
+	{
+		int currentSquadID;
+		if (m_mPlayerSquadIDs.Find(playerID, currentSquadID) && currentSquadID == squadID)
+			m_mPlayerSquadIDs.Remove(playerID);
+		
+		NarcoSquadRoster roster = m_mSquadRosters.Get(squadID);
+		if (!roster)
+			return;
+		
+		roster.RemoveMember(playerID);
+		if (roster.m_aMemberIDs.IsEmpty())
+			m_mSquadRosters.Remove(squadID);
 	}
 
 	//------------------------------------------------------------------------------------------------
-	//! Called every frame on the server to update proximity timers.
-    override void EOnFrame(IEntity owner, float timeSlice)
-    {
-        super.EOnFrame(owner, timeSlice);
-        
-        if (!m_bIsMaster || !m_GroupsManager || !m_bSquadXpEnabled)
-            return;
+	//! Called from the call queue at the configured evaluation rate to update proximity timers.
+	//! Each tick only evaluates one slice of the player list; the proximity grid is rebuilt once per full cycle.
+	private void EvaluateSquadXP()
+	{
+		if (!m_bIsMaster || !m_GroupsManager || !m_bSquadXpEnabled)
+			return;
+		
+		ChimeraWorld world = GetGame().GetWorld();
+		if (!world)
+			return;
+		
+		// Accumulate real server time for every slice, so awards stay correct regardless of the tick rate.
+		WorldTimestamp now = world.GetServerTimestamp();
+		float tickElapsed = 0;
+		if (m_LastTickTimestamp != 0)
+			tickElapsed = now.DiffSeconds(m_LastTickTimestamp);
+		m_LastTickTimestamp = now;
+		
+		for (int i = 0; i < m_iEvaluationSlices_Config; i++)
+		{
+			m_aSliceElapsedTime[i] = m_aSliceElapsedTime[i] + tickElapsed;
+		}
+		
+		int slice = m_iCurrentSlice;
+		m_iCurrentSlice = (m_iCurrentSlice + 1) % m_iEvaluationSlices_Config;
+		
+		float timeSlice = m_aSliceElapsedTime[slice];
+		m_aSliceElapsedTime[slice] = 0;
+		
+		if (slice == 0)
+			RebuildProximityGrid();
+		
+		foreach (int i, int playerID : m_aTickPlayerIDs)
+		{
+			if (playerID % m_iEvaluationSlices_Config != slice)
+				continue;
+			
+			// The buffers hold weak references. The state is dropped when the player disconnects or respawns,
+			// and the entity may have been deleted, since the grid was built.
+			NarcoSquadPlayerState state = m_aTickPlayerStates[i];
+			if (!state || !state.m_Entity)
+				continue;
+			
+			// Emptied rosters are removed, and a rebuild replaces all of them.
+			NarcoSquadRoster roster = m_aTickRosters[i];
+			if (!roster)
+				continue;
+			
+			int memberIndex = roster.m_aMemberIDs.Find(playerID);
+			if (memberIndex < 0)
+				continue;
 
-        array<int> players = {};
-        GetGame().GetPlayerManager().GetPlayers(players);
-        
-        foreach (int playerID : players)
-        {
-			string playerName = GetGame().GetPlayerManager().GetPlayerName(playerID);
-            IEntity playerEntity;
+			// Skip players who are in their main base.
+			if (IsInMainBase(state))
+				continue;
 
-			// Skip players who are dead or in their main base.
-            if (!IsPlayerAlive(playerID, playerEntity) || IsInMainBase(playerID, playerEntity))
-				continue; 
-				
-            SCR_AIGroup squad = m_GroupsManager.GetPlayerGroup(playerID);
-            if (!squad || squad.GetPlayerCount() < 2)
-                continue;
+			int nearbyMembers = m_ProximityGrid.CountNearbySquadmates(playerID);
 
 			// Increment proximity timer if near a squadmate.
-            if (IsNearLivingSquadmate(playerID, playerEntity, squad))
-            {
-                float currentTime = m_mPlayerProximityTimers.Get(playerID);
-                m_mPlayerProximityTimers.Set(playerID, currentTime + timeSlice);
-            }
-            
+			if (nearbyMembers > 0)
+				roster.m_aProximityTimers[memberIndex] = roster.m_aProximityTimers[memberIndex] + timeSlice;
+			
 			// Award XP if the timer reaches the threshold.
-            if (m_mPlayerProximityTimers.Get(playerID) >= m_fXpInterval_Config)
-            {
-				//Print(string.Format("Squad Incentive Mod: ...Player '%1' (ID: %2) reached XP threshold! Accrued Time: %3s / %4s", playerName, playerID, m_mPlayerProximityTimers.Get(playerID), m_fXpInterval_Config), LogLevel.NORMAL);
-                AwardAccruedXP(playerID, playerEntity, squad);
-                
-                float newTime = m_mPlayerProximityTimers.Get(playerID) - m_fXpInterval_Config;
-                m_mPlayerProximityTimers.Set(playerID, newTime);
-            }
-        }
-    }
+			if (roster.m_aProximityTimers[memberIndex] >= m_fXpInterval_Config)
+			{
+				AwardAccruedXP(playerID, roster.m_iLeaderID == playerID, nearbyMembers);
+				roster.m_aProximityTimers[memberIndex] = roster.m_aProximityTimers[memberIndex] - m_fXpInterval_Config;
+			}
+		}
+	}
 	
 	//------------------------------------------------------------------------------------------------
-	//! Calculates and awards XP based on role and number of nearby squadmates.
-	private void AwardAccruedXP(int playerID, IEntity playerEntity, SCR_AIGroup squad)
-    {
-		string playerName = GetGame().GetPlayerManager().GetPlayerName(playerID);
-        bool isLeader = (squad.GetLeaderID() == playerID);
-        
-		int nearbyMembers = 0;
-		array<int> memberIDs = squad.GetPlayerIDs();
-		foreach (int memberID : memberIDs)
+	//! Collects every living member of a squad of two or more and rebuilds the proximity grid from them.
+	//! Solo players and empty squads are never visited. Each player's entity is looked up once per rebuild.
+	private void RebuildProximityGrid()
+	{
+		m_ProximityGrid.Clear();
+		m_aTickPlayerIDs.Clear();
+		m_aTickPlayerStates.Clear();
+		m_aTickRosters.Clear();
+		
+		foreach (int squadID, NarcoSquadRoster roster : m_mSquadRosters)
 		{
-			if (memberID == playerID) continue;
-
-			IEntity memberEntity;
-			if (IsPlayerAlive(memberID, memberEntity) && vector.Distance(playerEntity.GetOrigin(), memberEntity.GetOrigin()) <= m_iProximityDistance_Config)
+			if (roster.m_aMemberIDs.Count() < 2)
+				continue;
+			
+			foreach (int playerID : roster.m_aMemberIDs)
 			{
-				nearbyMembers++;
+				NarcoSquadPlayerState state = GetPlayerState(playerID);
+				if (!state || !IsPlayerAlive(state))
+					continue;
+				
+				m_aTickPlayerIDs.Insert(playerID);
+				m_aTickPlayerStates.Insert(state);
+				m_aTickRosters.Insert(roster);
+				m_ProximityGrid.Insert(playerID, squadID, state.m_Entity.GetOrigin());
 			}
 		}
-
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Awards XP based on role and number of nearby squadmates, using the precomputed multiplier table.
+	private void AwardAccruedXP(int playerID, bool isLeader, int nearbyMembers)
+	{
 		if (nearbyMembers == 0)
 		{
-			//Print(string.Format("Squad Incentive Mod: ...Halting XP award for '%1', all squadmates moved out of range at the last moment.", playerName), LogLevel.WARNING);
+			//Print(string.Format("Squad Incentive Mod: ...Halting XP award for player %1, all squadmates moved out of range at the last moment.", playerID), LogLevel.WARNING);
 			return;
 		}
 
-		SCR_EXPRewards rewardType;
-		int baseXP;
-		float cap;
-
+		int typeIndex = 0;
 		if (isLeader)
-		{
-			rewardType = SCR_EXPRewards.SQUAD_LEADING;
-			cap = SQUAD_LEADING_CAP;
-		}
-		else
-		{
-			rewardType = SCR_EXPRewards.SQUAD_LEADER_PROXIMITY;
-			cap = SQUAD_COHESION_CAP;
-		}
+			typeIndex = 1;
 
-		baseXP = GetXPRewardAmount(rewardType);
-		if (baseXP <= 0)
-		{
-			//Print(string.Format("Squad Incentive Mod: ...Base XP for reward type '%1' is 0. Cannot calculate bonus. Check config.", typename.EnumToString(SCR_EXPRewards, rewardType)), LogLevel.ERROR);
+		float finalMultiplier = GetSquadXPMultiplier(typeIndex, nearbyMembers);
+		if (finalMultiplier <= 0)
 			return;
-		}
 
-		float finalMultiplier = 1.0;
+		//Print(string.Format("Squad Incentive Mod: ...Multiplier for player %1: Nearby=%2, FinalMult=%3", playerID, nearbyMembers, finalMultiplier), LogLevel.NORMAL);
+		this.AwardXP(playerID, m_aSquadRewardTypes[typeIndex], finalMultiplier);
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	private float GetSquadXPMultiplier(int typeIndex, int nearbyMembers)
+	{
+		int column = Math.Min(nearbyMembers, m_iSquadXPMultiplierRowSize - 1);
+		return m_aSquadXPMultipliers[typeIndex * m_iSquadXPMultiplierRowSize + column];
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Precomputes the bonus curve for every reward type and nearby-member count.
+	//! The multiplier grows linearly from 1.0 with one nearby member up to cap / baseXP at the configured member count.
+	private void BuildSquadXPMultiplierTable()
+	{
+		int maxMembers = Math.Max(m_iMaxSquadMembersForBonus_Config, 1);
+		m_iSquadXPMultiplierRowSize = maxMembers + 1;
+		m_aSquadXPMultipliers.Clear();
 		
-		if (nearbyMembers > 1)
+		foreach (SCR_EXPRewards rewardType : m_aSquadRewardTypes)
 		{
-			float maxMultiplier = cap / baseXP;
-			float bonusMultiplierRange = maxMultiplier - 1.0;
-			float effectiveBonusMembers = nearbyMembers - 1;
-			float bonusDenominator = MAX_SQUAD_MEMBERS_FOR_BONUS - 1.0;
-			float bonusRatio = Math.Min(effectiveBonusMembers / bonusDenominator, 1.0);
+			float cap = m_fSquadCohesionCap_Config;
+			if (rewardType == SCR_EXPRewards.SQUAD_LEADING)
+				cap = m_fSquadLeadingCap_Config;
+			
+			int baseXP = GetXPRewardAmount(rewardType);
+			if (baseXP <= 0)
+				Print(string.Format("Squad Incentive Mod: Base XP for reward type '%1' is 0. It will not be awarded, check config.", typename.EnumToString(SCR_EXPRewards, rewardType)), LogLevel.WARNING);
 			
-			float bonusMultiplier = bonusMultiplierRange * bonusRatio;
-			finalMultiplier = 1.0 + bonusMultiplier;
+			for (int nearbyMembers = 0; nearbyMembers < m_iSquadXPMultiplierRowSize; nearbyMembers++)
+			{
+				float multiplier = 0;
+				if (baseXP > 0 && nearbyMembers > 0)
+				{
+					float bonusRatio = 1.0;
+					if (maxMembers > 1)
+						bonusRatio = Math.Min((nearbyMembers - 1) / (maxMembers - 1.0), 1.0);
+					
+					multiplier = 1.0 + ((cap / baseXP) - 1.0) * bonusRatio;
+				}
+				
+				m_aSquadXPMultipliers.Insert(multiplier);
+			}
 		}
-
-		//Print(string.Format("Squad Incentive Mod: ...Multiplier Calculation for '%1': BaseXP=%2, Nearby=%3, FinalMult=%4", playerName, baseXP, nearbyMembers, finalMultiplier), LogLevel.NORMAL);
-        this.AwardXP(playerID, rewardType, finalMultiplier);
-		//Print(string.Format("Squad Incentive Mod: ...>>> Awarding scaled XP to '%1'.", playerName), LogLevel.NORMAL);
-    }
+	}
 	
 	//------------------------------------------------------------------------------------------------
-	//! Checks if the player is near at least one living squadmate.
-	private bool IsNearLivingSquadmate(int playerID, IEntity playerEntity, SCR_AIGroup squad)
-    {
-        array<int> memberIDs = squad.GetPlayerIDs();
-        foreach (int memberID : memberIDs)
-        {
-            if (playerID == memberID) continue;
-
-            IEntity memberEntity;
-            if (IsPlayerAlive(memberID, memberEntity))
-            {
-                if (vector.DistanceSq(playerEntity.GetOrigin(), memberEntity.GetOrigin()) <= (m_iProximityDistance_Config * m_iProximityDistance_Config))
-                {
-                    return true;
-                }
-            }
-        }
-        
-        return false;
-    }
+	//! Prints the expected XP per interval for each reward type and nearby-member count.
+	void PrintPayoutSchedule()
+	{
+		Print("Squad Incentive Mod: Expected payout schedule per interval:", LogLevel.NORMAL);
+		
+		foreach (int typeIndex, SCR_EXPRewards rewardType : m_aSquadRewardTypes)
+		{
+			int baseXP = GetXPRewardAmount(rewardType);
+			for (int nearbyMembers = 1; nearbyMembers < m_iSquadXPMultiplierRowSize; nearbyMembers++)
+			{
+				float multiplier = GetSquadXPMultiplier(typeIndex, nearbyMembers);
+				Print(string.Format("Squad Incentive Mod: ...%1, %2 nearby: x%3 = %4 XP", typename.EnumToString(SCR_EXPRewards, rewardType), nearbyMembers, multiplier, Math.Round(baseXP * multiplier)), LogLevel.NORMAL);
+			}
+		}
+	}
 	
 	//------------------------------------------------------------------------------------------------
-	//! Helper to check if a player is alive and get their entity.
-	private bool IsPlayerAlive(int playerID, out IEntity outEntity)
+	//! Returns the cached state for a player, building it on first use or after invalidation.
+	private NarcoSquadPlayerState GetPlayerState(int playerID)
 	{
-		outEntity = GetPlayerEntity(playerID);
-		if (!outEntity)
-			return false;
+		if (playerID < 0)
+			return null;
 		
-		ChimeraCharacter character = ChimeraCharacter.Cast(outEntity);
-		if (!character)
-			return false;
+		if (playerID >= m_aPlayerStates.Count())
+			m_aPlayerStates.Resize(playerID + 1);
 		
-		CharacterControllerComponent controller = character.GetCharacterController();
-		if (!controller)
-			return false;
+		NarcoSquadPlayerState state = m_aPlayerStates[playerID];
 		
-		return controller.GetLifeState() == ECharacterLifeState.ALIVE;
+		// The controlled entity was deleted without a spawn event (e.g. by a game master), rebuild.
+		if (!state || !state.m_Entity)
+		{
+			state = BuildPlayerState(playerID);
+			m_aPlayerStates[playerID] = state;
+		}
+		
+		return state;
+	}
+	
+	//------------------------------------------------------------------------------------------------
+	//! Drops the cached state of a player. It is rebuilt lazily the next time it is needed.
+	private void InvalidatePlayerState(int playerID)
+	{
+		if (playerID >= 0 && playerID < m_aPlayerStates.Count())
+			m_aPlayerStates[playerID] = null;
 	}
 	
 	//------------------------------------------------------------------------------------------------
-	//! Helper to get a player's controlled entity.
-	private IEntity GetPlayerEntity(int playerID)
+	//! Runs the full chain of lookups for a player once and stores the results.
+	private NarcoSquadPlayerState BuildPlayerState(int playerID)
 	{
+		NarcoSquadPlayerState state = new NarcoSquadPlayerState();
+		
 		PlayerController playerController = GetGame().GetPlayerManager().GetPlayerController(playerID);
-		if (!playerController)
-			return null;
+		if (playerController)
+			state.m_Entity = playerController.GetControlledEntity();
+		
+		ChimeraCharacter character = ChimeraCharacter.Cast(state.m_Entity);
+		if (character)
+			state.m_Controller = character.GetCharacterController();
+		
+		state.m_bAlive = state.m_Controller && state.m_Controller.GetLifeState() != ECharacterLifeState.DEAD;
+		
+		if (!m_CampaignFactionManager)
+			return state;
+		
+		state.m_Faction = SCR_CampaignFaction.Cast(m_CampaignFactionManager.GetPlayerFaction(playerID));
+		if (!state.m_Faction)
+			return state;
+		
+		SCR_CampaignMilitaryBaseComponent mainBase = state.m_Faction.GetMainBase();
+		if (!mainBase)
+			return state;
+		
+		float exclusionRadius = mainBase.GetRadius() + MAIN_BASE_EXCLUSION_PADDING;
+		state.m_vMainBaseOrigin = mainBase.GetOwner().GetOrigin();
+		state.m_fExclusionRadiusSq = exclusionRadius * exclusionRadius;
+		state.m_bHasMainBase = true;
 		
-		return playerController.GetControlledEntity();
+		return state;
 	}
 	
 	//------------------------------------------------------------------------------------------------
-	//! Checks if a player is inside their faction's main base.
-	private bool IsInMainBase(int playerID, IEntity playerEntity)
+	//! Checks if a player is alive (and not incapacitated) using their cached controller.
+	private bool IsPlayerAlive(NarcoSquadPlayerState state)
 	{
-		if (!playerEntity)
-			return false;
-	
-		SCR_CampaignFactionManager campaignFactionManager = SCR_CampaignFactionManager.Cast(GetGame().GetFactionManager());
-		if (!campaignFactionManager) 
-			return false;
-	
-		SCR_CampaignFaction playerFaction = SCR_CampaignFaction.Cast(campaignFactionManager.GetPlayerFaction(playerID));
-		if (!playerFaction)
-			return false;
-	
-		SCR_CampaignMilitaryBaseComponent mainBase = playerFaction.GetMainBase();
-		if (!mainBase)
+		if (!state.m_bAlive || !state.m_Entity || !state.m_Controller)
 			return false;
 		
-		float distanceToBase = vector.Distance(playerEntity.GetOrigin(), mainBase.GetOwner().GetOrigin());
-		float exclusionRadius = mainBase.GetRadius() + 100;
+		return state.m_Controller.GetLifeState() == ECharacterLifeState.ALIVE;
+	}
 	
-		if (distanceToBase <= exclusionRadius)
-		{
-			return true;
-		}
+	//------------------------------------------------------------------------------------------------
+	//! Checks if a player is inside their faction's main base.
+	private bool IsInMainBase(NarcoSquadPlayerState state)
+	{
+		if (!state.m_bHasMainBase || !state.m_Entity)
+			return false;
 		
-		return false;
+		return vector.DistanceSq(state.m_Entity.GetOrigin(), state.m_vMainBaseOrigin) <= state.m_fExclusionRadiusSq;
 	}
 }
 